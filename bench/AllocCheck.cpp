@@ -0,0 +1,198 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: detection of heap use and locking on the audio thread
+//  The replacements forward to glibc's __libc_* entry points, and only count while the calling thread
+//  is checking; thread-local state in the executable uses static TLS, which never allocates.
+//  The mutex wrappers forward to the next definition found by dlsym(RTLD_NEXT), resolved on first use.
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#include <new>
+#include "AllocCheck.hpp"
+#ifdef __GLIBC__
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <pthread.h>
+#endif
+
+
+namespace bench {
+
+static thread_local bool checking = false;
+static thread_local AllocCheckResult checkResult = {};
+
+static inline void countAllocation(size_t size) {
+	if (checking) {
+		if (checkResult.allocations == 0)
+			checkResult.firstSize = size;
+		checkResult.allocations++;
+	}
+}
+
+static inline void countFree(void *ptr) {
+	if (checking && ptr)
+		checkResult.frees++;
+}
+
+static inline void countLock() {
+	if (checking)
+		checkResult.locks++;
+}
+
+
+#ifdef __GLIBC__
+
+bool isAllocCheckSupported() {
+	return true;
+}
+
+#else
+
+bool isAllocCheckSupported() {
+	return false;
+}
+
+#endif
+
+void beginAllocCheck() {
+	checkResult = AllocCheckResult();
+	checking = true;
+}
+
+AllocCheckResult endAllocCheck() {
+	checking = false;
+	return checkResult;
+}
+
+}// namespace bench
+
+
+#ifdef __GLIBC__
+
+extern "C" {
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t num, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(size_t size) {
+	bench::countAllocation(size);
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t num, size_t size) {
+	bench::countAllocation(num * size);
+	return __libc_calloc(num, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+	bench::countAllocation(size);
+	return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) {
+	bench::countFree(ptr);
+	__libc_free(ptr);
+}
+
+void *memalign(size_t alignment, size_t size) {
+	bench::countAllocation(size);
+	return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+	bench::countAllocation(size);
+	return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size) {
+	bench::countAllocation(size);
+	if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+		return EINVAL;
+	*ptr = __libc_memalign(alignment, size);
+	return *ptr ? 0 : ENOMEM;
+}
+
+
+// No function-local static for the forwarded pointers: its guard may itself take a mutex
+typedef int (*MutexFunction)(pthread_mutex_t *mutex);
+static std::atomic<MutexFunction> nextMutexLock(NULL);
+static std::atomic<MutexFunction> nextMutexTrylock(NULL);
+
+static MutexFunction resolveMutexFunction(std::atomic<MutexFunction> &function, const char *name) {
+	MutexFunction next = function.load(std::memory_order_relaxed);
+	if (!next) {
+		next = (MutexFunction)dlsym(RTLD_NEXT, name);
+		function.store(next, std::memory_order_relaxed);
+	}
+	return next;
+}
+
+int pthread_mutex_lock(pthread_mutex_t *mutex) {
+	bench::countLock();
+	return resolveMutexFunction(nextMutexLock, "pthread_mutex_lock")(mutex);
+}
+
+int pthread_mutex_trylock(pthread_mutex_t *mutex) {
+	bench::countLock();
+	return resolveMutexFunction(nextMutexTrylock, "pthread_mutex_trylock")(mutex);
+}
+
+}// extern "C"
+
+
+// Global operator new/delete, counted once here rather than through malloc/free
+
+static void *allocate(size_t size) {
+	bench::countAllocation(size);
+	void *ptr = __libc_malloc(size ? size : 1);
+	if (!ptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void *operator new(size_t size) {
+	return allocate(size);
+}
+
+void *operator new[](size_t size) {
+	return allocate(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+	bench::countAllocation(size);
+	return __libc_malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+	bench::countAllocation(size);
+	return __libc_malloc(size ? size : 1);
+}
+
+void operator delete(void *ptr) noexcept {
+	bench::countFree(ptr);
+	__libc_free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+	bench::countFree(ptr);
+	__libc_free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+	bench::countFree(ptr);
+	__libc_free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+	bench::countFree(ptr);
+	__libc_free(ptr);
+}
+
+#endif
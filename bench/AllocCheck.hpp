@@ -0,0 +1,34 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: detection of heap use and locking on the audio thread
+//  The bench replaces malloc, calloc, realloc, free, the aligned allocators, the global operator
+//  new/delete and pthread_mutex_lock/trylock. Between beginAllocCheck() and endAllocCheck(), each call
+//  made by the checking thread is counted, so that a process() that allocates, frees or locks can be reported.
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#ifndef GEO_BENCH_ALLOCCHECK_HPP
+#define GEO_BENCH_ALLOCCHECK_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace bench {
+
+struct AllocCheckResult {
+	uint64_t allocations;// malloc, calloc, realloc, aligned allocations and operator new
+	uint64_t frees;// free and operator delete (of non NULL pointers)
+	uint64_t locks;// pthread_mutex_lock and pthread_mutex_trylock, which std::mutex and std::lock_guard go through
+	size_t firstSize;// size of the first allocation, to help find it
+};
+
+bool isAllocCheckSupported();// false when the C library's allocator and mutexes can not be wrapped (non glibc)
+void beginAllocCheck();
+AllocCheckResult endAllocCheck();
+
+}// namespace bench
+
+#endif
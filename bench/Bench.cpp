@@ -0,0 +1,315 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless benchmark: drives each model's process() outside of Rack over the scenario matrix
+//  (module, connected ports, mode flags) x sample rates declared in Scenarios.cpp
+//  The timings are of process() alone: a drive-only baseline of the test signals is measured first and subtracted
+//  Next to the timings, hardware counters (instructions, IPC, L1D read misses, branch misses) are
+//  reported per sample when perf_event_open is available, else shown as n/a. When built with
+//  GEO_PROCESS_TIMING, the percentiles of the modules' own process() histograms follow (TSC ticks per call)
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#include <cstdlib>
+#include "AllocCheck.hpp"
+#include "Denormals.hpp"
+#include "Density.hpp"
+#include "Golden.hpp"
+#include "Harness.hpp"
+#include "MathCheck.hpp"
+#include "PerfCounters.hpp"
+#include "Refresh.hpp"
+#include "Widgets.hpp"
+#ifdef GEO_PROCESS_TIMING
+#include "../src/Geodesics.hpp"
+#endif
+
+
+static const long blockFrames = 256;// one light refresh cycle (RefreshCounter::displayRefreshStepSkips)
+
+
+struct Result {
+	const bench::Scenario *scenario;
+	float sampleRate;
+	double nsPerSample;// best of the repeats, drive baseline subtracted
+	double cyclesPerSample;// TSC (reference) cycles, best of the repeats, drive baseline subtracted
+	double worstNsPerSample;// slowest block of blockFrames samples over all repeats, drive baseline subtracted
+	double countsPerSample[bench::PerfCounters::NUM_COUNTERS];// from the best repeat (drive included), negative when not available
+#ifdef GEO_PROCESS_TIMING
+	uint64_t processTicks[4];// p50, p99, p999 and max of the module's process() histogram over all repeats
+#endif
+};
+
+
+static void usage() {
+	printf("usage: geodesics-bench [-n samples] [-s sampleRate]... [-r repeats] [-S] [slug[/scenario] ...]\n");
+	printf("       geodesics-bench -g|-G [-f goldenFile] [slug[/scenario] ...]\n");
+	printf("       geodesics-bench -a [-n samples] [-s sampleRate]... [slug[/scenario] ...]\n");
+	printf("       geodesics-bench -d maxInstances [-n samples] [-s sampleRate] [-r repeats] [slug[/scenario] ...]\n");
+	printf("       geodesics-bench -w [-r repeats] [slug ...]\n");
+	printf("       geodesics-bench -m\n");
+	printf("       geodesics-bench -t threads\n");
+	printf("       geodesics-bench -c [-s sampleRate] [slug[/scenario] ...]\n");
+	printf("       geodesics-bench -z [-n samples] [-s sampleRate] [slug[/scenario] ...]\n");
+	printf("  -n  samples per repeat (default 262144)\n");
+	printf("  -s  sample rate, can be given more than once (default 44100 and 96000)\n");
+	printf("  -r  repeats, the best one is reported (default 3)\n");
+	printf("  -S  sort by cost, most expensive first\n");
+	printf("  -g  check the seeded renders of the scenarios against the golden file\n");
+	printf("  -G  rewrite the golden file from the current renders\n");
+	printf("  -f  golden file (default golden.json)\n");
+	printf("  -a  check that process() never allocates or frees heap memory nor locks a mutex, fails otherwise\n");
+	printf("  -d  density test with 1, 2, 4 ... maxInstances instances stepped like Rack's engine,\n");
+	printf("      -n is then the number of instance-samples per repeat (first scenario of each module by default)\n");
+	printf("  -w  widget construction time, loadSvg() calls and widget tree size of each module\n");
+	printf("  -m  check the maximum errors of the fast math approximations (GeoMath.hpp) against their documented bounds,\n");
+	printf("      and the ranges and lane independence of the random generator (GeoRandom)\n");
+	printf("  -t  check that the light and input refreshes of RefreshCounters stepped on that many threads, like Rack's\n");
+	printf("      multithreaded engine, are never doubled or skipped, also when the leader is bypassed\n");
+	printf("  -c  cost of the input and light refreshes of each module in TSC ticks, as given to its RefreshCounter\n");
+	printf("      (first scenario of each module by default)\n");
+	printf("  -z  denormal values in the filter states, with and without the FTZ/DAZ guard (GEO_DENORMAL_COUNT=1 build),\n");
+	printf("      -n samples driven then -n samples of silent inputs, fails when a state holds denormals under the guard\n");
+}
+
+
+// Per sample count with the given number of decimals, "n/a" when the counter is not available
+static std::string formatCount(double count, int decimals) {
+	if (count < 0.0)
+		return "n/a";
+	char buf[32];
+	snprintf(buf, sizeof(buf), "%.*f", decimals, count);
+	return buf;
+}
+
+
+static Result measure(const bench::Scenario &scenario, float sampleRate, long frames, int repeats, bench::PerfCounters &counters) {
+	Result result = {};
+	result.scenario = &scenario;
+	result.sampleRate = sampleRate;
+
+	bench::setSampleRate(sampleRate);
+	random::seed(bench::scenarioSeed(scenario));
+	bench::Instance instance(bench::getPlugin()->getModel(scenario.slug));
+	instance.configure(scenario);
+	instance.run(blockFrames * 4);// warm up caches and let connection dependent state settle
+#ifdef GEO_PROCESS_TIMING
+	if (getProcessTimes(instance.module))
+		getProcessTimes(instance.module)->reset();
+#endif
+
+	long blocks = std::max(frames / blockFrames, 1l);
+	double driveNs = 0.0;// per sample, best of the repeats
+	double driveCycles = 0.0;
+	for (int r = 0; r < repeats; r++) {
+		uint64_t startCycles = bench::readCycles();
+		double start = bench::nowNs();
+		for (long i = 0; i < blocks * blockFrames; i++)
+			instance.driveInputs();
+		double ns = (bench::nowNs() - start) / (double)(blocks * blockFrames);
+		if (r == 0 || ns < driveNs) {
+			driveNs = ns;
+			driveCycles = (bench::readCycles() - startCycles) / (double)(blocks * blockFrames);
+		}
+	}
+	instance.syncDrive();
+
+	for (int r = 0; r < repeats; r++) {
+		double totalNs = 0.0;
+		uint64_t totalCycles = 0;
+		counters.start();
+		for (long b = 0; b < blocks; b++) {
+			uint64_t startCycles = bench::readCycles();
+			double start = bench::nowNs();
+			instance.run(blockFrames);
+			double blockNs = bench::nowNs() - start;
+			totalCycles += bench::readCycles() - startCycles;
+			totalNs += blockNs;
+			result.worstNsPerSample = std::max(result.worstNsPerSample, blockNs / blockFrames - driveNs);
+		}
+		counters.stop();
+		double nsPerSample = totalNs / (double)(blocks * blockFrames) - driveNs;
+		if (r == 0 || nsPerSample < result.nsPerSample) {
+			result.nsPerSample = nsPerSample;
+			result.cyclesPerSample = totalCycles / (double)(blocks * blockFrames) - driveCycles;
+			for (int i = 0; i < bench::PerfCounters::NUM_COUNTERS; i++)
+				result.countsPerSample[i] = counters.isAvailable(i) ? counters.counts[i] / (double)(blocks * blockFrames) : -1.0;
+		}
+	}
+#ifdef GEO_PROCESS_TIMING
+	ProcessTimeHistogram *histogram = getProcessTimes(instance.module);
+	result.processTicks[0] = histogram ? histogram->getPercentile(0.5f) : 0;
+	result.processTicks[1] = histogram ? histogram->getPercentile(0.99f) : 0;
+	result.processTicks[2] = histogram ? histogram->getPercentile(0.999f) : 0;
+	result.processTicks[3] = histogram ? histogram->getMax() : 0;
+#endif
+	return result;
+}
+
+
+// Runs every scenario with the allocation and lock check armed around process() only (construction and configuration may allocate)
+static int checkAllocations(long frames, const std::vector<float> &sampleRates, const std::vector<std::string> &filters) {
+	if (!bench::isAllocCheckSupported()) {
+		fprintf(stderr, "allocation check needs glibc\n");
+		return 1;
+	}
+	int checks = 0;
+	int failures = 0;
+	for (const bench::Scenario &scenario : bench::getScenarios()) {
+		if (!bench::scenarioMatches(scenario, filters))
+			continue;
+		for (float sampleRate : sampleRates) {
+			bench::setSampleRate(sampleRate);
+			random::seed(bench::scenarioSeed(scenario));
+			bench::Instance instance(bench::getPlugin()->getModel(scenario.slug));
+			instance.configure(scenario);
+			bench::beginAllocCheck();
+			instance.run(frames);
+			bench::AllocCheckResult result = bench::endAllocCheck();
+
+			std::string full = std::string(scenario.slug) + "/" + scenario.name;
+			if (result.allocations == 0 && result.frees == 0 && result.locks == 0)
+				printf("%-40s %8.0f ok\n", full.c_str(), sampleRate);
+			else {
+				printf("%-40s %8.0f FAIL: %llu allocations (first of %zu bytes), %llu frees, %llu locks\n", full.c_str(), sampleRate, (unsigned long long)result.allocations, result.firstSize, (unsigned long long)result.frees, (unsigned long long)result.locks);
+				failures++;
+			}
+			checks++;
+		}
+	}
+	printf("%i of %i checks without heap use or locking in process()\n", checks - failures, checks);
+	return failures == 0 && checks > 0 ? 0 : 1;
+}
+
+
+int main(int argc, char **argv) {
+	long frames = 1 << 18;
+	std::vector<float> sampleRates;
+	int repeats = 3;
+	bool sortByCost = false;
+	int golden = 0;// 1 is check, 2 is update
+	std::string goldenPath = "golden.json";
+	int maxInstances = 0;// density test when not 0
+	bool allocCheck = false;
+	bool widgets = false;
+	bool denormals = false;
+	bool mathCheck = false;
+	int refreshThreads = 0;// refresh check when not 0
+	bool refreshCosts = false;
+	std::vector<std::string> filters;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "-n" && i + 1 < argc)
+			frames = atol(argv[++i]);
+		else if (arg == "-s" && i + 1 < argc)
+			sampleRates.push_back((float)atof(argv[++i]));
+		else if (arg == "-r" && i + 1 < argc)
+			repeats = atoi(argv[++i]);
+		else if (arg == "-S")
+			sortByCost = true;
+		else if (arg == "-g")
+			golden = 1;
+		else if (arg == "-G")
+			golden = 2;
+		else if (arg == "-f" && i + 1 < argc)
+			goldenPath = argv[++i];
+		else if (arg == "-a")
+			allocCheck = true;
+		else if (arg == "-w")
+			widgets = true;
+		else if (arg == "-z")
+			denormals = true;
+		else if (arg == "-m")
+			mathCheck = true;
+		else if (arg == "-c")
+			refreshCosts = true;
+		else if (arg == "-t" && i + 1 < argc)
+			refreshThreads = atoi(argv[++i]);
+		else if (arg == "-d" && i + 1 < argc)
+			maxInstances = atoi(argv[++i]);
+		else if (arg[0] == '-') {
+			usage();
+			return arg == "-h" ? 0 : 1;
+		}
+		else
+			filters.push_back(arg);
+	}
+	if (sampleRates.empty())
+		sampleRates = {44100.0f, 96000.0f};
+	for (float sampleRate : sampleRates) {
+		if (sampleRate <= 0.0f) {
+			usage();
+			return 1;
+		}
+	}
+	if (frames <= 0 || repeats <= 0 || maxInstances < 0 || refreshThreads < 0) {
+		usage();
+		return 1;
+	}
+
+	Plugin *plugin = bench::getPlugin();
+	if (golden != 0)
+		return bench::runGolden(goldenPath, golden == 2, filters);
+	if (maxInstances != 0)
+		return bench::runDensity(maxInstances, sampleRates[0], frames, repeats, filters);
+	if (allocCheck)
+		return checkAllocations(frames, sampleRates, filters);
+	if (widgets)
+		return bench::runWidgets(repeats, filters);
+	if (denormals)
+		return bench::runDenormals(frames, sampleRates[0], filters);
+	if (mathCheck)
+		return bench::runMathCheck();
+	if (refreshThreads != 0)
+		return bench::runRefreshCheck(refreshThreads);
+	if (refreshCosts)
+		return bench::runRefreshCosts(sampleRates[0], filters);
+
+	bench::PerfCounters counters;
+	if (!counters.isAnyAvailable())
+		fprintf(stderr, "hardware counters not available (perf_event_open), shown as n/a\n");
+
+	std::vector<Result> results;
+	for (const bench::Scenario &scenario : bench::getScenarios()) {
+		if (!bench::scenarioMatches(scenario, filters))
+			continue;
+		if (!plugin->getModel(scenario.slug)) {
+			fprintf(stderr, "scenario %s/%s: unknown module\n", scenario.slug, scenario.name);
+			return 1;
+		}
+		for (float sampleRate : sampleRates)
+			results.push_back(measure(scenario, sampleRate, frames, repeats, counters));
+	}
+	if (results.empty()) {
+		fprintf(stderr, "no scenario matches\n");
+		return 1;
+	}
+	if (sortByCost) {
+		std::stable_sort(results.begin(), results.end(), [](const Result &a, const Result &b) {
+			return a.nsPerSample > b.nsPerSample;
+		});
+	}
+
+	printf("%-40s %8s %10s %12s %10s %10s %6s %9s %9s", "module/scenario", "rate", "ns/sample", "tsc/sample", "worst ns", "instr", "IPC", "L1D miss", "br miss");
+#ifdef GEO_PROCESS_TIMING
+	printf(" %8s %8s %8s %8s", "p50 <", "p99 <", "p999 <", "max");// TSC ticks per process() call
+#endif
+	printf("\n");
+	for (const Result &result : results) {
+		std::string full = std::string(result.scenario->slug) + "/" + result.scenario->name;
+		const double *counts = result.countsPerSample;
+		bool hasIpc = counts[bench::PerfCounters::INSTRUCTIONS] >= 0.0 && counts[bench::PerfCounters::CYCLES] > 0.0;
+		printf("%-40s %8.0f %10.2f %12.1f %10.2f", full.c_str(), result.sampleRate, result.nsPerSample, result.cyclesPerSample, result.worstNsPerSample);
+		printf(" %10s", formatCount(counts[bench::PerfCounters::INSTRUCTIONS], 1).c_str());
+		printf(" %6s", formatCount(hasIpc ? counts[bench::PerfCounters::INSTRUCTIONS] / counts[bench::PerfCounters::CYCLES] : -1.0, 2).c_str());
+		printf(" %9s", formatCount(counts[bench::PerfCounters::L1D_MISSES], 3).c_str());
+		printf(" %9s", formatCount(counts[bench::PerfCounters::BRANCH_MISSES], 3).c_str());
+#ifdef GEO_PROCESS_TIMING
+		printf(" %8llu %8llu %8llu %8llu", (unsigned long long)result.processTicks[0], (unsigned long long)result.processTicks[1], (unsigned long long)result.processTicks[2], (unsigned long long)result.processTicks[3]);
+#endif
+		printf("\n");
+	}
+	return 0;
+}
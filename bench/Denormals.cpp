@@ -0,0 +1,87 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: denormal values in the recursive filter states, with and without the DenormalGuard
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#include "Denormals.hpp"
+#include "Harness.hpp"
+#ifdef GEO_DENORMAL_COUNT
+#include "../src/Geodesics.hpp"
+#endif
+
+
+namespace bench {
+
+#ifdef GEO_DENORMAL_COUNT
+
+struct StateCounts {
+	uint64_t checks;
+	uint64_t denormals;
+};
+
+
+// Counts of each state of the scenario's module after the driven then silent run, empty when the module has no counters
+static std::vector<StateCounts> runScenario(const Scenario &scenario, float sampleRate, long frames, bool guard, std::vector<std::string> &names) {
+	DenormalCounters::guardBypassed = !guard;
+	setSampleRate(sampleRate);
+	random::seed(scenarioSeed(scenario));
+	Instance instance(getPlugin()->getModel(scenario.slug));
+	instance.configure(scenario);
+	instance.run(frames);
+	instance.runSilent(frames);
+	DenormalCounters::guardBypassed = false;
+
+	std::vector<StateCounts> counts;
+	DenormalCounters *counters = getDenormalCounters(instance.module);
+	if (!counters)
+		return counts;
+	names.clear();
+	for (int i = 0; i < counters->numStates; i++) {
+		names.push_back(counters->names[i]);
+		counts.push_back({counters->checks[i].load(), counters->denormals[i].load()});
+	}
+	return counts;
+}
+
+
+int runDenormals(long frames, float sampleRate, const std::vector<std::string> &filters) {
+	int scenarios = 0;
+	int failures = 0;
+	printf("%-40s %-18s %12s %14s %14s\n", "module/scenario", "state", "checks", "with guard", "without guard");
+	for (const Scenario &scenario : getScenarios()) {
+		if (!scenarioMatches(scenario, filters))
+			continue;
+		std::vector<std::string> names;
+		std::vector<StateCounts> guarded = runScenario(scenario, sampleRate, frames, true, names);
+		std::vector<StateCounts> unguarded = runScenario(scenario, sampleRate, frames, false, names);
+		if (guarded.empty())
+			continue;
+		std::string full = std::string(scenario.slug) + "/" + scenario.name;
+		for (size_t i = 0; i < guarded.size(); i++) {
+			printf("%-40s %-18s %12llu %14llu %14llu\n", full.c_str(), names[i].c_str(), (unsigned long long)guarded[i].checks, (unsigned long long)guarded[i].denormals, (unsigned long long)unguarded[i].denormals);
+			if (guarded[i].denormals != 0)
+				failures++;
+		}
+		scenarios++;
+	}
+	if (scenarios == 0) {
+		fprintf(stderr, "no scenario with denormal counters matches\n");
+		return 1;
+	}
+	printf("%i states with denormals under the guard\n", failures);
+	return failures == 0 ? 0 : 1;
+}
+
+#else
+
+int runDenormals(long frames, float sampleRate, const std::vector<std::string> &filters) {
+	fprintf(stderr, "denormal counts need the GEO_DENORMAL_COUNT=1 build (geodesics-bench-denormals)\n");
+	return 1;
+}
+
+#endif
+
+}// namespace bench
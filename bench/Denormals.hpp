@@ -0,0 +1,26 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: denormal values in the recursive filter states, with and without the DenormalGuard
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#ifndef GEO_BENCH_DENORMALS_HPP
+#define GEO_BENCH_DENORMALS_HPP
+
+#include <string>
+#include <vector>
+
+
+namespace bench {
+
+// Runs the scenarios matching filters for frames samples with the test signals then frames samples of silent
+//   inputs (where the filter states decay toward 0), once with the DenormalGuard and once without, and prints how
+//   often each state of the modules' DenormalCounters held a denormal value. Needs the GEO_DENORMAL_COUNT build;
+//   returns the process exit code (1 when a state held denormals with the guard)
+int runDenormals(long frames, float sampleRate, const std::vector<std::string> &filters);
+
+}// namespace bench
+
+#endif
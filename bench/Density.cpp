@@ -0,0 +1,117 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: rack-scale density test, cost per instance as the number of instances grows
+//  Instances are stepped the way Rack's engine does it: for each sample, process() of every
+//  module in turn, so that each instance's state has to come back into the cache once per sample.
+//  The working set of an instance is approximated by the heap it holds after construction (the
+//  module object with its params, ports and lights, plus what its constructor allocates).
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#include <memory>
+#include <unistd.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include "Density.hpp"
+#include "Harness.hpp"
+
+
+namespace bench {
+
+// Heap bytes in use, 0 when the C library does not report it
+static size_t getHeapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+	return mallinfo2().uordblks;
+#else
+	return 0;
+#endif
+}
+
+
+static long getCacheSize(int name, long fallback) {
+	long size = sysconf(name);
+	return size > 0 ? size : fallback;
+}
+
+
+// Smallest cache level that holds bytes, as a label for the report
+static const char *getCacheLevel(double bytes) {
+	static const long l1 = getCacheSize(_SC_LEVEL1_DCACHE_SIZE, 32 * 1024);
+	static const long l2 = getCacheSize(_SC_LEVEL2_CACHE_SIZE, 256 * 1024);
+	static const long l3 = getCacheSize(_SC_LEVEL3_CACHE_SIZE, 8 * 1024 * 1024);
+	if (bytes <= 0.0)
+		return "?";
+	if (bytes <= l1)
+		return "L1";
+	if (bytes <= l2)
+		return "L2";
+	if (bytes <= l3)
+		return "L3";
+	return "DRAM";
+}
+
+
+static void runScenario(const Scenario &scenario, int maxInstances, long frames, int repeats) {
+	Model *model = getPlugin()->getModel(scenario.slug);
+	double baseNs = 0.0;
+	printf("%s/%s\n", scenario.slug, scenario.name);
+	printf("%10s %16s %8s %14s %6s\n", "instances", "ns/inst-sample", "vs 1", "working set KB", "fits");
+
+	for (int n = 1; ; n = std::min(n * 2, maxInstances)) {
+		random::seed(scenarioSeed(scenario));
+		std::vector<std::unique_ptr<Instance>> instances;
+		size_t heapBefore = getHeapInUse();
+		for (int i = 0; i < n; i++) {
+			instances.emplace_back(new Instance(model));
+			instances.back()->configure(scenario);
+		}
+		size_t heapAfter = getHeapInUse();
+		double workingSet = heapAfter > heapBefore ? (double)(heapAfter - heapBefore) : 0.0;
+
+		long blockFrames = 256;
+		long blocks = std::max(frames / ((long)n * blockFrames), 1l);
+		double bestNs = 0.0;
+		for (int r = -1; r < repeats; r++) {// first pass is a warm up
+			double start = nowNs();
+			for (long f = 0; f < (r < 0 ? 1 : blocks) * blockFrames; f++) {
+				for (int i = 0; i < n; i++)
+					instances[i]->step();
+			}
+			double ns = (nowNs() - start) / ((double)blocks * blockFrames * n);
+			if (r == 0 || (r > 0 && ns < bestNs))
+				bestNs = ns;
+		}
+		if (n == 1)
+			baseNs = bestNs;
+		printf("%10i %16.2f %7.2fx %14.1f %6s\n", n, bestNs, bestNs / baseNs, workingSet / 1024.0, getCacheLevel(workingSet));
+		fflush(stdout);
+		if (n >= maxInstances)
+			break;
+	}
+	printf("\n");
+}
+
+
+int runDensity(int maxInstances, float sampleRate, long frames, int repeats, const std::vector<std::string> &filters) {
+	setSampleRate(sampleRate);
+	printf("L1D %li KB, L2 %li KB, L3 %li KB; %.0f Hz\n\n", getCacheSize(_SC_LEVEL1_DCACHE_SIZE, 0) / 1024, getCacheSize(_SC_LEVEL2_CACHE_SIZE, 0) / 1024, getCacheSize(_SC_LEVEL3_CACHE_SIZE, 0) / 1024, sampleRate);
+	int count = 0;
+	std::string lastSlug;
+	for (const Scenario &scenario : getScenarios()) {
+		if (filters.empty() ? scenario.slug == lastSlug : !scenarioMatches(scenario, filters))
+			continue;
+		lastSlug = scenario.slug;
+		runScenario(scenario, maxInstances, frames, repeats);
+		count++;
+	}
+	if (count == 0) {
+		fprintf(stderr, "no scenario matches\n");
+		return 1;
+	}
+	return 0;
+}
+
+}// namespace bench
@@ -0,0 +1,25 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: rack-scale density test, cost per instance as the number of instances grows
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#ifndef GEO_BENCH_DENSITY_HPP
+#define GEO_BENCH_DENSITY_HPP
+
+#include <string>
+#include <vector>
+
+
+namespace bench {
+
+// Runs the scenarios matching filters (by default the first scenario of each module) with 1, 2, 4 ... maxInstances
+//   instances and prints the cost per instance-sample along with the working set and the cache level it fits in.
+//   frames is the number of instance-samples per repeat; returns the process exit code
+int runDensity(int maxInstances, float sampleRate, long frames, int repeats, const std::vector<std::string> &filters);
+
+}// namespace bench
+
+#endif
@@ -0,0 +1,245 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: golden-output regression check of every scenario with seeded randomness
+//  Each scenario is rendered for goldenFrames samples at goldenSampleRate from a seeded random
+//  source. The golden file keeps, per scenario, a hash of the bit patterns of all connected outputs
+//  and, per output, one probe sample every probeStride samples. Modules with a tolerance of 0 must
+//  match the hash bit-exactly; the others must stay within their tolerance at every probe.
+//  The goldens of the bit-exact modules are recorded with the default build: with -funsafe-math-optimizations,
+//  other build flags (GEO_PROCESS_TIMING for example) can change the code generation and thus the last bits of
+//  some modules. The goldens of the modules with a tolerance are recorded with the reference build
+//  (GEO_REFERENCE_MATH: the fast exp2/exp/pow through the standard library and IEEE denormals), so that the
+//  default build is checked against exact math; each build's -G keeps the other build's entries of the file.
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#include <cstring>
+#include "Golden.hpp"
+#include "Harness.hpp"
+
+
+namespace bench {
+
+static const long goldenFrames = 2048;
+static const float goldenSampleRate = 44100.0f;
+static const long probeStride = 32;
+
+
+// Absolute tolerance in volts allowed at the probes, per module; 0 means bit-exact. BlackHoles (exponential levels)
+//   and Torus (filter cutoffs) use the fast exp2/exp/pow, bounded in their renders by 1e-5 V; Energy also has the
+//   FTZ/DAZ guard inlined in process(), bounded by 1e-6 V
+static float getTolerance(const std::string &slug) {
+	static const std::vector<std::pair<std::string, float>> tolerances = {
+		{"BlackHoles", 1e-5f},
+		{"Pulsars", 0.0f},
+		{"Branes", 0.0f},
+		{"Ions", 0.0f},
+		{"Entropia", 0.0f},
+		{"Energy", 1e-6f},
+		{"Torus", 1e-5f},
+		{"Fate", 0.0f},
+		{"Blank-PanelLogo", 0.0f},
+		{"Blank-PanelInfo", 0.0f},
+	};
+	for (const std::pair<std::string, float> &tolerance : tolerances) {
+		if (tolerance.first == slug)
+			return tolerance.second;
+	}
+	return 0.0f;
+}
+
+
+// Whether this build records the golden entry of the scenario (see above)
+static bool recordsGolden(const Scenario &scenario) {
+#ifdef GEO_REFERENCE_MATH
+	return getTolerance(scenario.slug) > 0.0f;
+#else
+	return getTolerance(scenario.slug) <= 0.0f;
+#endif
+}
+
+
+struct Render {
+	std::vector<int> outputIds;// connected outputs
+	std::vector<std::vector<float>> samples;// [output][frame]
+	uint64_t hash = 0xcbf29ce484222325ULL;
+};
+
+
+static Render render(const Scenario &scenario) {
+	Render ret;
+	setSampleRate(goldenSampleRate);
+	random::seed(scenarioSeed(scenario));
+	Instance instance(getPlugin()->getModel(scenario.slug));
+	instance.configure(scenario);
+	for (int i = 0; i < (int)instance.module->outputs.size(); i++) {
+		if (instance.module->outputs[i].isConnected())
+			ret.outputIds.push_back(i);
+	}
+	ret.samples.resize(ret.outputIds.size());
+	for (long f = 0; f < goldenFrames; f++) {
+		instance.step();
+		for (int o = 0; o < (int)ret.outputIds.size(); o++) {
+			float v = instance.module->outputs[ret.outputIds[o]].getVoltage();
+			ret.samples[o].push_back(v);
+			uint32_t bits;
+			memcpy(&bits, &v, sizeof(bits));
+			for (int b = 0; b < 4; b++) {// FNV-1a
+				ret.hash ^= (bits >> (8 * b)) & 0xFF;
+				ret.hash *= 0x100000001b3ULL;
+			}
+		}
+	}
+	return ret;
+}
+
+
+static std::string hashString(uint64_t hash) {
+	char buf[20];
+	snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)hash);
+	return buf;
+}
+
+
+static void writeEntry(FILE *file, const std::string &hash, const std::vector<int> &outputIds, const std::vector<std::vector<float>> &probes) {
+	fprintf(file, "\t\"hash\": \"%s\",\n\t\"outputs\": {", hash.c_str());
+	for (size_t o = 0; o < outputIds.size(); o++) {
+		fprintf(file, "%s\n\t\t\"%i\": [", o == 0 ? "" : ",", outputIds[o]);
+		for (size_t p = 0; p < probes[o].size(); p++)// -0 as 0, since the json parser reads -0 as the integer 0
+			fprintf(file, "%s%.9g", p == 0 ? "" : ", ", probes[o][p] == 0.0f ? 0.0f : probes[o][p]);
+		fprintf(file, "]");
+	}
+	fprintf(file, "\n\t}\n");
+}
+
+
+// Rewrites the entries this build records and copies the others from the current file
+static bool writeGolden(const std::string &path, const std::vector<const Scenario*> &scenarios) {
+	json_t *oldRootJ = json_load_file(path.c_str(), 0, NULL);
+	FILE *file = fopen(path.c_str(), "w");
+	if (!file) {
+		fprintf(stderr, "unable to write %s\n", path.c_str());
+		json_decref(oldRootJ);
+		return false;
+	}
+	int recorded = 0;
+	int missing = 0;
+	fprintf(file, "{\n");
+	for (size_t s = 0; s < scenarios.size(); s++) {
+		std::string full = std::string(scenarios[s]->slug) + "/" + scenarios[s]->name;
+		json_t *oldJ = json_object_get(oldRootJ, full.c_str());
+		if (!recordsGolden(*scenarios[s]) && !oldJ) {
+			fprintf(stderr, "%s: no entry to keep, record it with the other build\n", full.c_str());
+			missing++;
+			continue;
+		}
+		fprintf(file, "%s\"%s\": {\n", s == 0 ? "" : ",\n", full.c_str());
+		if (recordsGolden(*scenarios[s])) {
+			Render r = render(*scenarios[s]);
+			std::vector<std::vector<float>> probes(r.outputIds.size());
+			for (size_t o = 0; o < r.outputIds.size(); o++) {
+				for (long f = 0; f < goldenFrames; f += probeStride)
+					probes[o].push_back(r.samples[o][f]);
+			}
+			writeEntry(file, hashString(r.hash), r.outputIds, probes);
+			recorded++;
+		}
+		else {
+			std::vector<int> outputIds;
+			std::vector<std::vector<float>> probes;
+			json_t *outputsJ = json_object_get(oldJ, "outputs");
+			for (int id = 0; id < 64 && outputIds.size() < json_object_size(outputsJ); id++) {// keys are the output ids
+				json_t *probesJ = json_object_get(outputsJ, std::to_string(id).c_str());
+				if (!probesJ)
+					continue;
+				outputIds.push_back(id);
+				probes.push_back(std::vector<float>());
+				for (size_t p = 0; p < json_array_size(probesJ); p++)
+					probes.back().push_back((float)json_number_value(json_array_get(probesJ, p)));
+			}
+			writeEntry(file, json_string_value(json_object_get(oldJ, "hash")), outputIds, probes);
+		}
+		fprintf(file, "}");
+	}
+	fprintf(file, "\n}\n");
+	fclose(file);
+	json_decref(oldRootJ);
+	printf("recorded %i of %i scenarios in %s, kept the others\n", recorded, (int)scenarios.size(), path.c_str());
+	return missing == 0;
+}
+
+
+// Returns an empty string when the render matches the golden entry, else a description of the first mismatch;
+//   maxError is the largest difference at the probes when the hash differs, else 0
+static std::string compare(const Scenario &scenario, json_t *goldenJ, float &maxError) {
+	Render r = render(scenario);
+	maxError = 0.0f;
+	json_t *hashJ = json_object_get(goldenJ, "hash");
+	if (hashJ && hashString(r.hash) == json_string_value(hashJ))
+		return "";
+	float tolerance = getTolerance(scenario.slug);
+	if (tolerance <= 0.0f)
+		return "hash differs (bit-exact module)";
+
+	json_t *outputsJ = json_object_get(goldenJ, "outputs");
+	if (json_object_size(outputsJ) != r.outputIds.size())
+		return "connected outputs differ";
+	for (size_t o = 0; o < r.outputIds.size(); o++) {
+		json_t *probesJ = json_object_get(outputsJ, std::to_string(r.outputIds[o]).c_str());
+		if (!probesJ)
+			return "output " + std::to_string(r.outputIds[o]) + " missing in golden";
+		for (long f = 0, p = 0; f < goldenFrames; f += probeStride, p++) {
+			float expected = (float)json_number_value(json_array_get(probesJ, p));
+			maxError = std::max(maxError, std::fabs(r.samples[o][f] - expected));
+			if (!(std::fabs(r.samples[o][f] - expected) <= tolerance)) {
+				char buf[128];
+				snprintf(buf, sizeof(buf), "output %i frame %li: %.9g, expected %.9g (tolerance %g)", r.outputIds[o], f, r.samples[o][f], expected, tolerance);
+				return buf;
+			}
+		}
+	}
+	return "";
+}
+
+
+int runGolden(const std::string &path, bool update, const std::vector<std::string> &filters) {
+	std::vector<const Scenario*> scenarios;
+	for (const Scenario &scenario : getScenarios()) {
+		if (scenarioMatches(scenario, filters))
+			scenarios.push_back(&scenario);
+	}
+	if (update) {
+		if (!filters.empty()) {
+			fprintf(stderr, "the golden file is always rewritten for all scenarios, remove the filters\n");
+			return 1;
+		}
+		return writeGolden(path, scenarios) ? 0 : 1;
+	}
+
+	json_error_t error;
+	json_t *rootJ = json_load_file(path.c_str(), 0, &error);
+	if (!rootJ) {
+		fprintf(stderr, "%s:%i: %s\n", path.c_str(), error.line, error.text);
+		return 1;
+	}
+	int failures = 0;
+	for (const Scenario *scenario : scenarios) {
+		std::string full = std::string(scenario->slug) + "/" + scenario->name;
+		json_t *goldenJ = json_object_get(rootJ, full.c_str());
+		float maxError = 0.0f;
+		std::string mismatch = goldenJ ? compare(*scenario, goldenJ, maxError) : "no golden entry (rewrite with -G)";
+		if (mismatch.empty() && maxError > 0.0f)
+			printf("%-40s ok, max error %.3g V (tolerance %g)\n", full.c_str(), maxError, getTolerance(scenario->slug));
+		else
+			printf("%-40s %s\n", full.c_str(), mismatch.empty() ? "ok" : ("FAIL: " + mismatch).c_str());
+		if (!mismatch.empty())
+			failures++;
+	}
+	json_decref(rootJ);
+	printf("%i of %i scenarios match %s\n", (int)scenarios.size() - failures, (int)scenarios.size(), path.c_str());
+	return failures == 0 ? 0 : 1;
+}
+
+}// namespace bench
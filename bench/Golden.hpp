@@ -0,0 +1,24 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: golden-output regression check of every scenario with seeded randomness
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#ifndef GEO_BENCH_GOLDEN_HPP
+#define GEO_BENCH_GOLDEN_HPP
+
+#include <string>
+#include <vector>
+
+
+namespace bench {
+
+// Renders every scenario matching filters and compares it with the golden file (update == false),
+//   or rewrites the golden file from the current renders (update == true). Returns the process exit code.
+int runGolden(const std::string &path, bool update, const std::vector<std::string> &filters);
+
+}// namespace bench
+
+#endif
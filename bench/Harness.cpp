@@ -0,0 +1,80 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench harness: module instancing and signal driving on top of the shim in ./include
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#include "Harness.hpp"
+
+
+namespace bench {
+
+Plugin *getPlugin() {
+	static Plugin *plugin = NULL;
+	if (!plugin) {
+		random::init();
+		plugin = new Plugin;
+		init(plugin);
+	}
+	return plugin;
+}
+
+void setSampleRate(float sampleRate) {
+	APP->engine->sampleRate = sampleRate;
+}
+
+
+Instance::Instance(Model *_model) {
+	model = _model;
+	module = model->createModule();
+	args.sampleRate = APP->engine->getSampleRate();
+	args.sampleTime = APP->engine->getSampleTime();
+	module->onAdd();
+}
+
+Instance::~Instance() {
+	module->onRemove();
+	delete module;
+}
+
+void Instance::connectAll() {
+	connect(ALL_PORTS, ALL_PORTS);
+}
+
+void Instance::connect(uint64_t inputMask, uint64_t outputMask) {
+	drivenInputs.clear();
+	for (int i = 0; i < (int)module->inputs.size(); i++) {
+		bool connected = ((inputMask >> i) & 0x1) != 0;
+		module->inputs[i].setChannels(connected ? 1 : 0);
+		if (connected)
+			drivenInputs.push_back({&module->inputs[i], testSignalPeriod(i), 0});
+		else
+			module->inputs[i].setVoltage(0.0f);
+	}
+	syncDrive();
+	for (int i = 0; i < (int)module->outputs.size(); i++)
+		module->outputs[i].setChannels(((outputMask >> i) & 0x1) != 0 ? 1 : 0);
+}
+
+void Instance::configure(const Scenario &scenario) {
+	connect(scenario.inputMask, scenario.outputMask);
+	for (const std::pair<int, float> &param : scenario.params)
+		module->params[param.first].setValue(param.second);
+	json_error_t error;
+	json_t *rootJ = json_loads(scenario.json, 0, &error);
+	if (!rootJ) {
+		fprintf(stderr, "%s/%s: invalid scenario json: %s\n", scenario.slug, scenario.name, error.text);
+		return;
+	}
+	module->dataFromJson(rootJ);
+	json_decref(rootJ);
+}
+
+void Instance::syncDrive() {
+	for (DrivenInput &driven : drivenInputs)
+		driven.phase = (int)(frame % driven.period);
+}
+
+}// namespace bench
@@ -0,0 +1,104 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench harness: module instancing and signal driving on top of the shim in ./include
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#ifndef GEO_BENCH_HARNESS_HPP
+#define GEO_BENCH_HARNESS_HPP
+
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "rack.hpp"
+#include "Scenarios.hpp"
+
+
+using namespace rack;
+
+
+namespace bench {
+
+// The plugin with all Geodesics models added, as done by Rack when loading the plugin
+Plugin *getPlugin();
+
+// Sets the engine sample rate; call before creating instances (modules read it in their constructors)
+void setSampleRate(float sampleRate);
+
+
+// Deterministic test signal for input port portId: a unipolar 0V/5V square with a port-dependent
+//   period, high for the first half of each period, so that clocks and triggers fire and mixers see moving values
+inline int testSignalPeriod(int portId) {
+	return 96 + 26 * portId;
+}
+
+// A connected input and the phase of its test signal. The drive runs inside the timed region, so it
+//   steps a phase counter per port instead of taking frame % period for every port on every sample
+struct DrivenInput {
+	Input *input;
+	int period;
+	int phase;// frame % period
+};
+
+
+struct Instance {
+	Model *model;
+	Module *module;
+	Module::ProcessArgs args;
+	long frame = 0;
+	std::vector<DrivenInput> drivenInputs;// connected inputs, set by connect()
+
+	Instance(Model *_model);
+	~Instance();
+
+	void connectAll();
+	void connect(uint64_t inputMask, uint64_t outputMask);
+	void configure(const Scenario &scenario);// connects, sets params then applies the scenario's json
+	void syncDrive();// sets the phases of drivenInputs from frame
+	inline void driveInputs() {
+		for (DrivenInput &driven : drivenInputs) {
+			driven.input->setVoltage(driven.phase < (driven.period >> 1) ? 5.0f : 0.0f);
+			if (++driven.phase == driven.period)
+				driven.phase = 0;
+		}
+	}
+	inline void step() {
+		driveInputs();
+		module->process(args);
+		frame++;
+	}
+	void run(long frames) {
+		for (long i = 0; i < frames; i++)
+			step();
+	}
+	void runSilent(long frames) {// connected inputs held at 0V, so that the recursive states decay
+		for (int i = 0; i < (int)module->inputs.size(); i++)
+			module->inputs[i].setVoltage(0.0f);
+		for (long i = 0; i < frames; i++) {
+			module->process(args);
+			frame++;
+		}
+		syncDrive();
+	}
+};
+
+
+inline double nowNs() {
+	return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Time stamp counter, 0 when not available on this architecture
+inline uint64_t readCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+}// namespace bench
+
+#endif
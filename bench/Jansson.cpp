@@ -0,0 +1,352 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench shim: implementation of the jansson subset declared in include/jansson.h
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+#include <jansson.h>
+
+
+struct json_t {
+	json_type type;
+	long refcount;
+	json_int_t integer;
+	double real;
+	std::string string;
+	std::vector<std::pair<std::string, json_t*>> object;
+	std::vector<json_t*> array;
+};
+
+
+static json_t trueSingleton = {JSON_TRUE, -1, 0, 0.0, "", {}, {}};
+static json_t falseSingleton = {JSON_FALSE, -1, 0, 0.0, "", {}, {}};
+static json_t nullSingleton = {JSON_NULL, -1, 0, 0.0, "", {}, {}};
+
+
+static json_t *newJson(json_type type) {
+	json_t *json = new json_t;
+	json->type = type;
+	json->refcount = 1;
+	json->integer = 0;
+	json->real = 0.0;
+	return json;
+}
+
+
+json_t *json_object() {return newJson(JSON_OBJECT);}
+json_t *json_array() {return newJson(JSON_ARRAY);}
+json_t *json_string(const char *value) {
+	if (!value)
+		return NULL;
+	json_t *json = newJson(JSON_STRING);
+	json->string = value;
+	return json;
+}
+json_t *json_integer(json_int_t value) {
+	json_t *json = newJson(JSON_INTEGER);
+	json->integer = value;
+	return json;
+}
+json_t *json_real(double value) {
+	json_t *json = newJson(JSON_REAL);
+	json->real = value;
+	return json;
+}
+json_t *json_true() {return &trueSingleton;}
+json_t *json_false() {return &falseSingleton;}
+json_t *json_null() {return &nullSingleton;}
+
+
+json_t *json_incref(json_t *json) {
+	if (json && json->refcount != -1)
+		json->refcount++;
+	return json;
+}
+
+void json_decref(json_t *json) {
+	if (!json || json->refcount == -1)
+		return;
+	if (--json->refcount > 0)
+		return;
+	for (auto &member : json->object)
+		json_decref(member.second);
+	for (json_t *element : json->array)
+		json_decref(element);
+	delete json;
+}
+
+
+json_type json_typeof(const json_t *json) {
+	return json->type;
+}
+
+json_int_t json_integer_value(const json_t *json) {
+	return json_is_integer(json) ? json->integer : 0;
+}
+double json_real_value(const json_t *json) {
+	return json_is_real(json) ? json->real : 0.0;
+}
+double json_number_value(const json_t *json) {
+	if (json_is_integer(json))
+		return (double)json->integer;
+	return json_real_value(json);
+}
+const char *json_string_value(const json_t *json) {
+	return json_is_string(json) ? json->string.c_str() : NULL;
+}
+
+
+int json_object_set_new(json_t *object, const char *key, json_t *value) {
+	if (!json_is_object(object) || !key || !value) {
+		json_decref(value);
+		return -1;
+	}
+	for (auto &member : object->object) {
+		if (member.first == key) {
+			json_decref(member.second);
+			member.second = value;
+			return 0;
+		}
+	}
+	object->object.emplace_back(key, value);
+	return 0;
+}
+int json_object_set(json_t *object, const char *key, json_t *value) {
+	return json_object_set_new(object, key, json_incref(value));
+}
+json_t *json_object_get(const json_t *object, const char *key) {
+	if (!json_is_object(object) || !key)
+		return NULL;
+	for (auto &member : object->object) {
+		if (member.first == key)
+			return member.second;
+	}
+	return NULL;
+}
+size_t json_object_size(const json_t *object) {
+	return json_is_object(object) ? object->object.size() : 0;
+}
+
+
+int json_array_append_new(json_t *array, json_t *value) {
+	if (!json_is_array(array) || !value) {
+		json_decref(value);
+		return -1;
+	}
+	array->array.push_back(value);
+	return 0;
+}
+size_t json_array_size(const json_t *array) {
+	return json_is_array(array) ? array->array.size() : 0;
+}
+json_t *json_array_get(const json_t *array, size_t index) {
+	if (!json_is_array(array) || index >= array->array.size())
+		return NULL;
+	return array->array[index];
+}
+
+
+// Parser (strict enough for Rack patches and the bench's own files; \u escapes are kept as '?')
+
+struct JsonParser {
+	const char *s;
+	int line = 1;
+	const char *lineStart;
+	json_error_t *error;
+
+	JsonParser(const char *input, json_error_t *_error) : s(input), lineStart(input), error(_error) {}
+
+	json_t *fail(const char *msg) {
+		if (error) {
+			error->line = line;
+			error->column = (int)(s - lineStart) + 1;
+			snprintf(error->text, sizeof(error->text), "%s", msg);
+		}
+		return NULL;
+	}
+
+	void skipSpace() {
+		while (*s == ' ' || *s == '\t' || *s == '\r' || *s == '\n') {
+			if (*s == '\n') {
+				line++;
+				lineStart = s + 1;
+			}
+			s++;
+		}
+	}
+
+	bool parseString(std::string &out) {
+		s++;// opening quote
+		while (*s != '"') {
+			if (*s == '\0')
+				return false;
+			if (*s == '\\') {
+				s++;
+				switch (*s) {
+					case 'n': out += '\n'; break;
+					case 't': out += '\t'; break;
+					case 'r': out += '\r'; break;
+					case 'b': out += '\b'; break;
+					case 'f': out += '\f'; break;
+					case 'u':
+						for (int i = 0; i < 4; i++) {
+							if (s[1] == '\0')
+								return false;
+							s++;
+						}
+						out += '?';
+					break;
+					case '\0': return false;
+					default: out += *s; break;
+				}
+				s++;
+			}
+			else
+				out += *s++;
+		}
+		s++;// closing quote
+		return true;
+	}
+
+	json_t *parseValue() {
+		skipSpace();
+		if (*s == '{') {
+			s++;
+			json_t *object = json_object();
+			skipSpace();
+			if (*s == '}') {
+				s++;
+				return object;
+			}
+			while (true) {
+				skipSpace();
+				std::string key;
+				if (*s != '"' || !parseString(key)) {
+					json_decref(object);
+					return fail("string or '}' expected");
+				}
+				skipSpace();
+				if (*s++ != ':') {
+					json_decref(object);
+					return fail("':' expected");
+				}
+				json_t *value = parseValue();
+				if (!value) {
+					json_decref(object);
+					return NULL;
+				}
+				json_object_set_new(object, key.c_str(), value);
+				skipSpace();
+				if (*s == ',') {
+					s++;
+					continue;
+				}
+				if (*s++ == '}')
+					return object;
+				json_decref(object);
+				return fail("',' or '}' expected");
+			}
+		}
+		if (*s == '[') {
+			s++;
+			json_t *array = json_array();
+			skipSpace();
+			if (*s == ']') {
+				s++;
+				return array;
+			}
+			while (true) {
+				json_t *value = parseValue();
+				if (!value) {
+					json_decref(array);
+					return NULL;
+				}
+				json_array_append_new(array, value);
+				skipSpace();
+				if (*s == ',') {
+					s++;
+					continue;
+				}
+				if (*s++ == ']')
+					return array;
+				json_decref(array);
+				return fail("',' or ']' expected");
+			}
+		}
+		if (*s == '"') {
+			std::string str;
+			if (!parseString(str))
+				return fail("unterminated string");
+			return json_string(str.c_str());
+		}
+		if (strncmp(s, "true", 4) == 0) {
+			s += 4;
+			return json_true();
+		}
+		if (strncmp(s, "false", 5) == 0) {
+			s += 5;
+			return json_false();
+		}
+		if (strncmp(s, "null", 4) == 0) {
+			s += 4;
+			return json_null();
+		}
+		const char *start = s;
+		bool isReal = false;
+		if (*s == '-')
+			s++;
+		while ((*s >= '0' && *s <= '9') || *s == '.' || *s == 'e' || *s == 'E' || *s == '+' || *s == '-') {
+			if (*s == '.' || *s == 'e' || *s == 'E')
+				isReal = true;
+			s++;
+		}
+		if (s == start)
+			return fail("invalid token");
+		std::string number(start, s);
+		if (isReal)
+			return json_real(strtod(number.c_str(), NULL));
+		return json_integer(strtoll(number.c_str(), NULL, 10));
+	}
+};
+
+
+json_t *json_loads(const char *input, size_t flags, json_error_t *error) {
+	if (!input)
+		return NULL;
+	JsonParser parser(input, error);
+	json_t *root = parser.parseValue();
+	if (root) {
+		parser.skipSpace();
+		if (*parser.s != '\0') {
+			json_decref(root);
+			return parser.fail("end of file expected");
+		}
+	}
+	return root;
+}
+
+json_t *json_load_file(const char *path, size_t flags, json_error_t *error) {
+	FILE *file = fopen(path, "rb");
+	if (!file) {
+		if (error) {
+			error->line = -1;
+			error->column = -1;
+			snprintf(error->text, sizeof(error->text), "unable to open %s", path);
+		}
+		return NULL;
+	}
+	std::string contents;
+	char buf[4096];
+	size_t len;
+	while ((len = fread(buf, 1, sizeof(buf), file)) > 0)
+		contents.append(buf, len);
+	fclose(file);
+	return json_loads(contents.c_str(), flags, error);
+}
@@ -0,0 +1,145 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: error check of the fast math approximations in ../src/GeoMath.hpp, and range and lane
+//  independence check of the modules' random generator (GeoRandom in ../src/Geodesics.hpp)
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#include <cmath>
+#include <functional>
+#include "MathCheck.hpp"
+#include "../src/GeoMath.hpp"
+#include "../src/Geodesics.hpp"
+
+
+namespace bench {
+
+static const long sweepPoints = 1 << 22;
+
+
+// Largest relative error of the scalar and SIMD versions of fast against the reference over [lo, hi], and number
+//   of inputs where the SIMD lanes differ from the scalar version
+static bool checkFunction(const char *name, float lo, float hi, float bound,
+		std::function<float(float)> fast, std::function<simd::float_4(simd::float_4)> fast4, std::function<double(double)> reference) {
+	double maxError = 0.0;
+	float worstX = lo;
+	long laneMismatches = 0;
+	for (long i = 0; i < sweepPoints; i += 4) {
+		float xs[4];
+		for (int j = 0; j < 4; j++)
+			xs[j] = lo + (hi - lo) * (float)((double)(i + j) / (double)(sweepPoints - 1));
+		if (i + 4 >= sweepPoints)
+			xs[3] = hi;
+		simd::float_4 ys = fast4(simd::float_4::load(xs));
+		for (int j = 0; j < 4; j++) {
+			float y = fast(xs[j]);
+			if (y != ys[j])
+				laneMismatches++;
+			double expected = reference((double)xs[j]);
+			double error = std::fabs(((double)y - expected) / expected);
+			if (error > maxError) {
+				maxError = error;
+				worstX = xs[j];
+			}
+		}
+	}
+	bool ok = maxError <= bound && laneMismatches == 0;
+	printf("%-10s [%8.2f, %8.2f] max rel error %9.3g at %10.5f, bound %9.3g, %li SIMD lane mismatches %s\n", name, lo, hi, maxError, worstX, bound, laneMismatches, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+
+// Ranges of GeoRandom's draws, uniform() in [0, 1) and the lanes of fillBipolar() in [-1, 1), with their means, and
+//   largest correlation between two lanes of the same draw or of consecutive draws (lag 1, also of a lane with itself).
+//   Independent streams give correlations of about 1 / sqrt(draws), the bounds are 5 times that
+static bool checkRandom() {
+	const int draws = 1 << 20;// of 4 lanes
+	const int blockDraws = 64;
+	GeoRandom rng;
+	rng.seed(0x9E3779B97F4A7C15ULL);
+
+	double bipolarMin = 1.0, bipolarMax = -1.0;
+	double sums[4] = {}, squares[4] = {};
+	double products[4][4] = {};// same draw, [i][j] for i < j
+	double lagProducts[4][4] = {};// lane i of a draw with lane j of the next one
+	float previous[4] = {};
+	float block[4 * blockDraws];
+	for (int d = 0; d < draws; d += blockDraws) {
+		rng.fillBipolar(block, 4 * blockDraws);
+		for (int b = 0; b < blockDraws; b++) {
+			const float *v = &block[4 * b];
+			for (int i = 0; i < 4; i++) {
+				bipolarMin = std::min(bipolarMin, (double)v[i]);
+				bipolarMax = std::max(bipolarMax, (double)v[i]);
+				sums[i] += v[i];
+				squares[i] += (double)v[i] * v[i];
+				for (int j = 0; j < 4; j++) {
+					if (i < j)
+						products[i][j] += (double)v[i] * v[j];
+					if (d + b > 0)
+						lagProducts[j][i] += (double)previous[j] * v[i];
+				}
+			}
+			for (int i = 0; i < 4; i++)
+				previous[i] = v[i];
+		}
+	}
+	double worstMean = 0.0;
+	double worstCorrelation = 0.0;
+	for (int i = 0; i < 4; i++) {
+		worstMean = std::max(worstMean, std::fabs(sums[i] / draws));
+		for (int j = 0; j < 4; j++) {
+			double norm = std::sqrt(squares[i] * squares[j]);// the means are about 0
+			if (i < j)
+				worstCorrelation = std::max(worstCorrelation, std::fabs(products[i][j] / norm));
+			worstCorrelation = std::max(worstCorrelation, std::fabs(lagProducts[i][j] / norm));
+		}
+	}
+
+	double uniformMin = 1.0, uniformMax = 0.0, uniformSum = 0.0;
+	for (int d = 0; d < 4 * draws; d++) {
+		double u = rng.uniform();
+		uniformMin = std::min(uniformMin, u);
+		uniformMax = std::max(uniformMax, u);
+		uniformSum += u;
+	}
+	double uniformMean = uniformSum / (4.0 * draws);
+
+	double meanBound = 5.0 * std::sqrt(1.0 / 3.0 / draws);// standard deviation of the mean of a lane of bipolar draws
+	double correlationBound = 5.0 / std::sqrt((double)draws);
+	bool ok = bipolarMin >= -1.0 && bipolarMax < 1.0 && uniformMin >= 0.0 && uniformMax < 1.0
+		&& worstMean <= meanBound && std::fabs(uniformMean - 0.5) <= meanBound && worstCorrelation <= correlationBound;
+	printf("GeoRandom  bipolar lanes [%.7f, %.7f] max |mean| %9.3g, uniform [%.7f, %.7f] mean %.5f, bound %9.3g\n", bipolarMin, bipolarMax, worstMean, uniformMin, uniformMax, uniformMean, meanBound);
+	printf("GeoRandom  max lane correlation %9.3g (same and next draw), bound %9.3g %s\n", worstCorrelation, correlationBound, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+
+int runMathCheck() {
+	int failures = 0;
+	if (!checkFunction("fastExp2", -126.0f, 126.0f, fastExp2MaxError,
+			[](float x) {return fastExp2(x);}, [](simd::float_4 x) {return fastExp2(x);}, [](double x) {return std::exp2(x);}))
+		failures++;
+	if (!checkFunction("fastExp2", -10.0f, 10.0f, fastExp2MaxError,
+			[](float x) {return fastExp2(x);}, [](simd::float_4 x) {return fastExp2(x);}, [](double x) {return std::exp2(x);}))
+		failures++;
+	if (!checkFunction("fastExp", -10.0f, 10.0f, fastExpMaxError,
+			[](float x) {return fastExp(x);}, [](simd::float_4 x) {return fastExp(x);}, [](double x) {return std::exp(x);}))
+		failures++;
+	// BlackHoles' exponential levels (base 50 over the level range)
+	if (!checkFunction("fastPow 50", -2.0f, 2.0f, fastPowMaxError,
+			[](float x) {return fastPow(50.0f, x);}, [](simd::float_4 x) {return fastPow(50.0f, x);}, [](double x) {return std::pow(50.0, x);}))
+		failures++;
+	// OnePoleFilter cutoffs, exp(-2 * pi * Fc) with Fc = f_c / sampleRate in [0, 0.5]
+	if (!checkFunction("fastExp", -(float)M_PI, 0.0f, fastExpMaxError,
+			[](float x) {return fastExp(x);}, [](simd::float_4 x) {return fastExp(x);}, [](double x) {return std::exp(x);}))
+		failures++;
+	if (!checkRandom())
+		failures++;
+	printf("%i of 6 checks within their bounds\n", 6 - failures);
+	return failures == 0 ? 0 : 1;
+}
+
+}// namespace bench
@@ -0,0 +1,23 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: error check of the fast math approximations in ../src/GeoMath.hpp
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#ifndef GEO_BENCH_MATH_CHECK_HPP
+#define GEO_BENCH_MATH_CHECK_HPP
+
+
+namespace bench {
+
+// Sweeps fastExp2, fastExp and fastPow (scalar and SIMD) over their documented domains, compares them with the
+//   double precision standard library and prints the maximum relative errors next to the documented bounds.
+//   Then checks the ranges, means and lane correlations of GeoRandom's draws. Returns the process exit code (1 when
+//   an error is above its bound, a SIMD lane differs from the scalar, or a draw check fails)
+int runMathCheck();
+
+}// namespace bench
+
+#endif
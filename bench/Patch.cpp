@@ -0,0 +1,135 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: Rack patch (.vcv, v1 plain JSON) made only of Geodesics modules and their cables
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#include "Harness.hpp"
+#include "Patch.hpp"
+
+
+namespace bench {
+
+Patch::Patch() {
+	args.sampleRate = APP->engine->getSampleRate();
+	args.sampleTime = APP->engine->getSampleTime();
+}
+
+Patch::~Patch() {
+	for (PatchModule &patchModule : modules) {
+		patchModule.module->onRemove();
+		delete patchModule.module;
+	}
+}
+
+
+bool Patch::load(const std::string &path, std::string &error) {
+	json_error_t jsonError;
+	json_t *rootJ = json_load_file(path.c_str(), 0, &jsonError);
+	if (!rootJ) {
+		// Rack v2 patches are zstd compressed archives, they need to be unpacked to their patch.json first
+		error = path + ":" + std::to_string(jsonError.line) + ": " + jsonError.text;
+		return false;
+	}
+	bool ret = fromJson(rootJ, error);
+	json_decref(rootJ);
+	return ret;
+}
+
+
+bool Patch::fromJson(json_t *rootJ, std::string &error) {
+	Plugin *plugin = getPlugin();
+
+	json_t *modulesJ = json_object_get(rootJ, "modules");
+	if (!json_is_array(modulesJ)) {
+		error = "no modules in patch";
+		return false;
+	}
+	for (size_t m = 0; m < json_array_size(modulesJ); m++) {
+		json_t *moduleJ = json_array_get(modulesJ, m);
+		json_t *pluginJ = json_object_get(moduleJ, "plugin");
+		json_t *modelJ = json_object_get(moduleJ, "model");
+		std::string pluginSlug = pluginJ ? json_string_value(pluginJ) : "";
+		std::string modelSlug = modelJ ? json_string_value(modelJ) : "";
+		Model *model = pluginSlug == plugin->slug ? plugin->getModel(modelSlug) : NULL;
+		if (!model) {
+			error = "module " + pluginSlug + "/" + modelSlug + " is not a Geodesics module";
+			return false;
+		}
+
+		PatchModule patchModule;
+		patchModule.model = model;
+		patchModule.module = model->createModule();
+		json_t *idJ = json_object_get(moduleJ, "id");
+		patchModule.module->id = idJ ? (int)json_integer_value(idJ) : (int)m;
+		json_t *bypassJ = json_object_get(moduleJ, "bypass");
+		patchModule.bypass = json_is_true(bypassJ);
+		modules.push_back(patchModule);
+		patchModule.module->onAdd();
+
+		// Same as Module::fromJson() in Rack v1
+		json_t *paramsJ = json_object_get(moduleJ, "params");
+		for (size_t p = 0; p < json_array_size(paramsJ); p++) {
+			json_t *paramJ = json_array_get(paramsJ, p);
+			json_t *paramIdJ = json_object_get(paramJ, "id");
+			if (!paramIdJ)
+				paramIdJ = json_object_get(paramJ, "paramId");// Rack 0.6
+			json_t *valueJ = json_object_get(paramJ, "value");
+			size_t paramId = paramIdJ ? (size_t)json_integer_value(paramIdJ) : p;
+			if (valueJ && paramId < patchModule.module->params.size())
+				patchModule.module->params[paramId].setValue((float)json_number_value(valueJ));
+		}
+		json_t *dataJ = json_object_get(moduleJ, "data");
+		if (dataJ)
+			patchModule.module->dataFromJson(dataJ);
+	}
+
+	json_t *cablesJ = json_object_get(rootJ, "cables");
+	if (!cablesJ)
+		cablesJ = json_object_get(rootJ, "wires");// Rack 0.6
+	for (size_t c = 0; c < json_array_size(cablesJ); c++) {
+		json_t *cableJ = json_array_get(cablesJ, c);
+		Module *outputModule = getModule((int)json_integer_value(json_object_get(cableJ, "outputModuleId")));
+		Module *inputModule = getModule((int)json_integer_value(json_object_get(cableJ, "inputModuleId")));
+		size_t outputId = (size_t)json_integer_value(json_object_get(cableJ, "outputId"));
+		size_t inputId = (size_t)json_integer_value(json_object_get(cableJ, "inputId"));
+		if (!outputModule || !inputModule || outputId >= outputModule->outputs.size() || inputId >= inputModule->inputs.size()) {
+			error = "cable " + std::to_string(c) + " has an unknown end";
+			return false;
+		}
+		PatchCable cable = {&outputModule->outputs[outputId], &inputModule->inputs[inputId]};
+		// As Engine::addCable(): a connected output has at least one channel
+		if (cable.output->channels == 0)
+			cable.output->setChannels(1);
+		cable.input->setChannels(1);
+		cables.push_back(cable);
+	}
+	return true;
+}
+
+
+Module *Patch::getModule(int id) {
+	for (PatchModule &patchModule : modules) {
+		if (patchModule.module->id == id)
+			return patchModule.module;
+	}
+	return NULL;
+}
+
+
+void Patch::step() {
+	for (PatchModule &patchModule : modules) {
+		if (!patchModule.bypass)
+			patchModule.module->process(args);
+	}
+	for (PatchCable &cable : cables) {
+		int channels = cable.output->channels;
+		cable.input->channels = channels;
+		for (int c = 0; c < channels; c++)
+			cable.input->voltages[c] = cable.output->voltages[c];
+	}
+}
+
+}// namespace bench
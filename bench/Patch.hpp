@@ -0,0 +1,53 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: Rack patch (.vcv, v1 plain JSON) made only of Geodesics modules and their cables
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#ifndef GEO_BENCH_PATCH_HPP
+#define GEO_BENCH_PATCH_HPP
+
+#include <string>
+#include <vector>
+#include "rack.hpp"
+
+
+using namespace rack;
+
+
+namespace bench {
+
+struct Patch {
+	struct PatchModule {
+		Model *model;
+		Module *module;
+		bool bypass;
+	};
+	struct PatchCable {
+		Output *output;
+		Input *input;
+	};
+
+	std::vector<PatchModule> modules;// in patch order, which is the order Rack steps them in
+	std::vector<PatchCable> cables;
+	Module::ProcessArgs args;
+
+	Patch();
+	~Patch();
+
+	// Creates the modules with the engine's current sample rate and restores them (params then dataFromJson()),
+	//   then connects the cables; returns false with a message in error when the patch can not be rendered
+	bool load(const std::string &path, std::string &error);
+	bool fromJson(json_t *rootJ, std::string &error);
+	Module *getModule(int id);
+
+	// One engine frame: process() of every module, then the cables copy outputs to inputs,
+	//   so that a cable delays its signal by one sample as in Rack
+	void step();
+};
+
+}// namespace bench
+
+#endif
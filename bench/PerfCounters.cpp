@@ -0,0 +1,99 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: hardware performance counters (Linux perf_event_open) around process() loops
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#include <cstring>
+#include "PerfCounters.hpp"
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+namespace bench {
+
+#ifdef __linux__
+
+static int openCounter(uint32_t type, uint64_t config) {
+	perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = type;
+	attr.config = config;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;// allowed with the default perf_event_paranoid of 2
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+PerfCounters::PerfCounters() {
+	fds[INSTRUCTIONS] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+	fds[CYCLES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+	fds[L1D_MISSES] = openCounter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+	fds[BRANCH_MISSES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+	for (int i = 0; i < NUM_COUNTERS; i++)
+		counts[i] = 0;
+}
+
+PerfCounters::~PerfCounters() {
+	for (int i = 0; i < NUM_COUNTERS; i++) {
+		if (fds[i] >= 0)
+			close(fds[i]);
+	}
+}
+
+void PerfCounters::start() {
+	for (int i = 0; i < NUM_COUNTERS; i++) {
+		counts[i] = 0;
+		if (fds[i] >= 0) {
+			ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+			ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+}
+
+void PerfCounters::stop() {
+	for (int i = 0; i < NUM_COUNTERS; i++) {
+		if (fds[i] < 0)
+			continue;
+		ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+		uint64_t values[3];// value, time enabled, time running
+		if (read(fds[i], values, sizeof(values)) != (ssize_t)sizeof(values))
+			continue;
+		if (values[2] > 0 && values[2] < values[1])// counter was multiplexed with others, extrapolate
+			counts[i] = (uint64_t)((double)values[0] * (double)values[1] / (double)values[2]);
+		else
+			counts[i] = values[0];
+	}
+}
+
+#else
+
+PerfCounters::PerfCounters() {
+	for (int i = 0; i < NUM_COUNTERS; i++) {
+		fds[i] = -1;
+		counts[i] = 0;
+	}
+}
+PerfCounters::~PerfCounters() {}
+void PerfCounters::start() {}
+void PerfCounters::stop() {}
+
+#endif
+
+bool PerfCounters::isAnyAvailable() {
+	for (int i = 0; i < NUM_COUNTERS; i++) {
+		if (isAvailable(i))
+			return true;
+	}
+	return false;
+}
+
+}// namespace bench
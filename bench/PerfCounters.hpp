@@ -0,0 +1,42 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: hardware performance counters (Linux perf_event_open) around process() loops
+//  Counters that the kernel or the CPU does not provide (containers, VMs without a virtual PMU,
+//  perf_event_paranoid > 2, other OSes) are reported as not available instead of failing the run.
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#ifndef GEO_BENCH_PERFCOUNTERS_HPP
+#define GEO_BENCH_PERFCOUNTERS_HPP
+
+#include <cstdint>
+
+
+namespace bench {
+
+struct PerfCounters {
+	enum CounterIds {
+		INSTRUCTIONS,
+		CYCLES,
+		L1D_MISSES,// L1 data cache read misses
+		BRANCH_MISSES,
+		NUM_COUNTERS
+	};
+
+	int fds[NUM_COUNTERS];// -1 when the counter could not be opened
+	uint64_t counts[NUM_COUNTERS];// accumulated between start() and stop(), scaled when multiplexed
+
+	PerfCounters();// opens the counters for the calling thread, user space only
+	~PerfCounters();
+
+	bool isAvailable(int id) {return fds[id] >= 0;}
+	bool isAnyAvailable();
+	void start();// resets counts and starts counting
+	void stop();// stops counting and reads counts
+};
+
+}// namespace bench
+
+#endif
@@ -0,0 +1,209 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: control-rate refreshes of the RefreshCounters (see ../src/Geodesics.hpp)
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#include <condition_variable>
+#include <memory>
+#include <thread>
+#include "Harness.hpp"
+#include "Refresh.hpp"
+#include "../src/Geodesics.hpp"
+
+
+namespace bench {
+
+static const int numCounters = 64;
+static const long checkFrames = 20000;
+static const int costCycles = 2048;// light cycles timed per scenario
+
+
+// All threads wait in wait() until the last one arrives
+struct FrameBarrier {
+	std::mutex mutex;
+	std::condition_variable condition;
+	int numThreads;
+	int waiting = 0;
+	unsigned long generation = 0;
+
+	FrameBarrier(int _numThreads) : numThreads(_numThreads) {}
+
+	void wait() {
+		std::unique_lock<std::mutex> lock(mutex);
+		unsigned long arrival = generation;
+		if (++waiting == numThreads) {
+			waiting = 0;
+			generation++;
+			condition.notify_all();
+		}
+		else
+			condition.wait(lock, [&]() {return generation != arrival;});
+	}
+};
+
+
+struct CheckedCounter {
+	std::unique_ptr<RefreshCounter> counter;
+	long bypassStart = -1;// frames [bypassStart, bypassEnd) not processed
+	long bypassEnd = -1;
+	long lastLights = -1;// frame of the last light refresh
+	long lastInputs = -1;
+	int irregularLights = 0;// intervals other than 256 frames that do not span the bypass
+	int irregularInputs = 0;
+
+	bool isBypassed(long frame) {
+		return frame >= bypassStart && frame < bypassEnd;
+	}
+	void check(long &last, long frame, long interval, int &irregular) {
+		if (last >= 0 && frame - last != interval && !(last < bypassEnd && frame >= bypassStart))
+			irregular++;
+		last = frame;
+	}
+	void process(long frame) {
+		if (isBypassed(frame))
+			return;
+		if (counter->processLights())
+			check(lastLights, frame, RefreshCounter::displayRefreshStepSkips, irregularLights);
+		if (counter->processInputs())
+			check(lastInputs, frame, RefreshCounter::userInputsStepSkipMask + 1, irregularInputs);
+	}
+};
+
+
+int runRefreshCheck(int numThreads) {
+	std::vector<CheckedCounter> counters(numCounters);
+	for (CheckedCounter &checked : counters)
+		checked.counter.reset(new RefreshCounter());
+	// the leader first, then four others for less time, then the leader of that time
+	counters[0].bypassStart = 5000;
+	counters[0].bypassEnd = 8000;
+	for (int i = 1; i < 5; i++) {
+		counters[i].bypassStart = 10000;
+		counters[i].bypassEnd = 10600;
+	}
+	const long secondLeaderBypass = 12000;
+
+	std::atomic<int> next(0);
+	FrameBarrier barrier(numThreads);
+	int takeovers = 0;
+	RefreshCounter *lastLeader = RefreshCounter::leader.load();
+	auto work = [&](int thread) {
+		for (long frame = 0; frame < checkFrames; frame++) {
+			barrier.wait();
+			for (int i = next.fetch_add(1); i < numCounters; i = next.fetch_add(1))
+				counters[i].process(frame);
+			barrier.wait();
+			if (thread == 0) {// the others wait for it at the next frame
+				next = 0;
+				RefreshCounter *leader = RefreshCounter::leader.load();
+				if (leader != lastLeader)
+					takeovers++;
+				lastLeader = leader;
+				if (frame + 1 == secondLeaderBypass) {
+					for (CheckedCounter &checked : counters) {
+						if (checked.counter.get() == leader) {
+							checked.bypassStart = secondLeaderBypass;
+							checked.bypassEnd = secondLeaderBypass + 1000;
+						}
+					}
+				}
+			}
+		}
+	};
+	std::vector<std::thread> threads;
+	for (int t = 1; t < numThreads; t++)
+		threads.push_back(std::thread(work, t));
+	work(0);
+	for (std::thread &thread : threads)
+		thread.join();
+
+	int irregularLights = 0;
+	int irregularInputs = 0;
+	unsigned int minFrame = counters[0].counter->frame;
+	unsigned int maxFrame = minFrame;
+	for (CheckedCounter &checked : counters) {
+		irregularLights += checked.irregularLights;
+		irregularInputs += checked.irregularInputs;
+		minFrame = std::min(minFrame, checked.counter->frame);
+		maxFrame = std::max(maxFrame, checked.counter->frame);
+	}
+	// In step, the counts differ by the order of the leader in a frame, and by one more after a resync
+	bool ok = irregularLights == 0 && irregularInputs == 0 && maxFrame - minFrame <= 2 && takeovers >= 2;
+	printf("%i threads, %i counters, %li frames, %i leader takeovers\n", numThreads, numCounters, checkFrames, takeovers);
+	printf("%i irregular light refreshes, %i irregular input refreshes, frame count spread %u %s\n", irregularLights, irregularInputs, maxFrame - minFrame, ok ? "ok" : "FAIL");
+	return ok ? 0 : 1;
+}
+
+
+static float median(std::vector<float> values) {
+	std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+	return values[values.size() / 2];
+}
+
+
+static void measureCosts(const Scenario &scenario, float sampleRate) {
+	static const int cycle = RefreshCounter::displayRefreshStepSkips;
+	static const int numPhases = RefreshCounter::userInputsStepSkipMask + 1;
+	random::seed(scenarioSeed(scenario));
+	Instance instance(getPlugin()->getModel(scenario.slug));
+	instance.configure(scenario);
+	instance.run(cycle * 16);// warm up
+
+	// Median ticks of each sample of the cycle, the call itself (the driving of the inputs is not timed)
+	std::vector<std::vector<float>> ticks(cycle, std::vector<float>(costCycles));
+	for (int c = 0; c < costCycles; c++) {
+		for (int s = 0; s < cycle; s++) {
+			instance.driveInputs();
+			uint64_t start = readCycles();
+			instance.module->process(instance.args);
+			ticks[s][c] = (float)(readCycles() - start);
+			instance.frame++;
+		}
+	}
+	std::vector<float> medians(cycle);
+	for (int s = 0; s < cycle; s++)
+		medians[s] = median(ticks[s]);
+
+	// The light refresh is the slowest sample; the inputs are refreshed on the samples after each multiple of 16
+	//   from there (RefreshCounter::processInputs() reads the counter set by the previous processLights())
+	int lightSample = (int)(std::max_element(medians.begin(), medians.end()) - medians.begin());
+	int inputPhase = (lightSample + 1) % numPhases;
+	std::vector<float> others;
+	float inputSum = 0.0f;
+	for (int s = 0; s < cycle; s++) {
+		if (s % numPhases == inputPhase)
+			inputSum += medians[s];
+		else if (s != lightSample)
+			others.push_back(medians[s]);
+	}
+	float base = median(others);
+	float inputCost = std::max(inputSum / (cycle / numPhases) - base, 0.0f);
+	float lightCost = std::max(medians[lightSample] - base, 0.0f);
+	std::string full = std::string(scenario.slug) + "/" + scenario.name;
+	printf("%-40s %10.0f %12.0f %12.0f\n", full.c_str(), base, inputCost, lightCost);
+}
+
+
+int runRefreshCosts(float sampleRate, const std::vector<std::string> &filters) {
+	setSampleRate(sampleRate);
+	printf("%-40s %10s %12s %12s\n", "module/scenario", "base", "input ticks", "light ticks");
+	int count = 0;
+	std::string lastSlug;
+	for (const Scenario &scenario : getScenarios()) {
+		if (filters.empty() ? scenario.slug == lastSlug : !scenarioMatches(scenario, filters))
+			continue;
+		lastSlug = scenario.slug;
+		measureCosts(scenario, sampleRate);
+		count++;
+	}
+	if (count == 0) {
+		fprintf(stderr, "no scenario matches\n");
+		return 1;
+	}
+	return 0;
+}
+
+}// namespace bench
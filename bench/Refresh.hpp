@@ -0,0 +1,33 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: control-rate refreshes of the RefreshCounters (see ../src/Geodesics.hpp)
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#ifndef GEO_BENCH_REFRESH_HPP
+#define GEO_BENCH_REFRESH_HPP
+
+#include <string>
+#include <vector>
+
+
+namespace bench {
+
+// Steps RefreshCounters on numThreads threads the way Rack's multithreaded engine steps modules (each thread takes
+//   the next counter until all are done, then all threads wait for the next frame), with a few counters bypassed
+//   for a while, the leader among them. Fails when a counter's light or input refresh comes twice or is skipped
+//   outside of its own bypass, or when the frame counts of the counters drift apart. Returns the process exit code
+int runRefreshCheck(int numThreads);
+
+// Times every process() call of the scenarios matching filters (by default the first scenario of each module) and
+//   folds the times over the 256 sample light cycle, then prints the cost of the module's light refresh (the
+//   slowest sample) and of its input refresh (the slowest of the 16 sample phases) over the other samples, in TSC
+//   ticks: the costs to give to the module's RefreshCounter. In a throughput scenario, the slowest sample is the block
+//   kernel instead. Returns the process exit code
+int runRefreshCosts(float sampleRate, const std::vector<std::string> &filters);
+
+}// namespace bench
+
+#endif
@@ -0,0 +1,228 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Offline patch renderer: renders Geodesics-only Rack patches to WAV files as fast as the CPU allows
+//  Each rendered output becomes one channel of the WAV, scaled like Rack's Audio module (10V is full scale).
+//  In batch mode the patches of a list file are spread over all cores by a work-stealing pool; every
+//  patch has its own module instances and its random source seeded from its path, so that the
+//  renders do not depend on which thread picks them or in what order. The exception is a module's saved random
+//  seed that another patch of the batch also holds (copies of one patch): the module is then seen as a duplicate,
+//  as it would be in one Rack patch, and whichever copy loads last draws a new seed. Render such copies in separate batches.
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include "Harness.hpp"
+#include "Patch.hpp"
+#include "Wav.hpp"
+#include "WorkPool.hpp"
+
+
+static const long blockFrames = 256;
+
+
+struct RenderOutput {
+	int moduleId;
+	int outputId;
+};
+
+struct RenderJob {
+	std::string patchPath;
+	std::string wavPath;
+	std::vector<RenderOutput> outputs;
+	// Set by render()
+	bool ok = false;
+	std::string message;
+	double elapsedNs = 0.0;
+};
+
+
+static void usage() {
+	printf("usage: geodesics-render [-s sampleRate] [-l seconds] -o moduleId:outputId [-o ...] patch.vcv out.wav\n");
+	printf("       geodesics-render [-s sampleRate] [-l seconds] [-j threads] -b listFile\n");
+	printf("  -s  sample rate (default 44100)\n");
+	printf("  -l  length in seconds (default 10)\n");
+	printf("  -o  output to render, as the module id in the patch and the output index; one WAV channel each\n");
+	printf("  -b  batch of patches, one per line: patch.vcv out.wav moduleId:outputId [moduleId:outputId ...]\n");
+	printf("  -j  worker threads for -b (default one per hardware thread)\n");
+}
+
+
+static bool parseOutput(const std::string &arg, RenderOutput &output) {
+	return sscanf(arg.c_str(), "%i:%i", &output.moduleId, &output.outputId) == 2;
+}
+
+
+// Seed of the random source of a patch, FNV-1a of its path
+static uint64_t patchSeed(const std::string &path) {
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for (char c : path) {
+		hash ^= (uint8_t)c;
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+
+static bool readBatch(const std::string &path, std::vector<RenderJob> &jobs) {
+	std::ifstream file(path);
+	if (!file) {
+		fprintf(stderr, "unable to read %s\n", path.c_str());
+		return false;
+	}
+	std::string line;
+	for (int lineNum = 1; std::getline(file, line); lineNum++) {
+		std::istringstream tokens(line);
+		RenderJob job;
+		if (!(tokens >> job.patchPath) || job.patchPath[0] == '#')
+			continue;
+		bool valid = (bool)(tokens >> job.wavPath);
+		std::string outputArg;
+		while (valid && tokens >> outputArg) {
+			RenderOutput output;
+			valid = parseOutput(outputArg, output);
+			job.outputs.push_back(output);
+		}
+		if (!valid || job.outputs.empty()) {
+			fprintf(stderr, "%s:%i: expected patch.vcv out.wav moduleId:outputId ...\n", path.c_str(), lineNum);
+			return false;
+		}
+		jobs.push_back(job);
+	}
+	return true;
+}
+
+
+// Runs on any worker thread: everything it touches is owned by the job, apart from the plugin's models
+//   and the engine sample rate, which are set up before the workers start and only read here
+static void render(RenderJob &job, float sampleRate, long frames) {
+	random::seed(patchSeed(job.patchPath));
+	bench::Patch patch;
+	if (!patch.load(job.patchPath, job.message))
+		return;
+	std::vector<Output*> outputs;
+	for (const RenderOutput &renderOutput : job.outputs) {
+		Module *module = patch.getModule(renderOutput.moduleId);
+		if (!module || renderOutput.outputId < 0 || renderOutput.outputId >= (int)module->outputs.size()) {
+			job.message = "no output " + std::to_string(renderOutput.moduleId) + ":" + std::to_string(renderOutput.outputId) + " in the patch";
+			return;
+		}
+		Output *output = &module->outputs[renderOutput.outputId];
+		// The renderer is a cable into an audio interface: modules that skip unconnected outputs must compute it
+		if (output->channels == 0)
+			output->setChannels(1);
+		outputs.push_back(output);
+	}
+
+	bench::WavWriter wav;
+	if (!wav.open(job.wavPath, (int)outputs.size(), (int)sampleRate)) {
+		job.message = "unable to write " + job.wavPath;
+		return;
+	}
+	std::vector<float> buffer(blockFrames * outputs.size());
+	double start = bench::nowNs();
+	for (long f = 0; f < frames; f += blockFrames) {
+		long numFrames = std::min(blockFrames, frames - f);
+		for (long i = 0; i < numFrames; i++) {
+			patch.step();
+			for (size_t o = 0; o < outputs.size(); o++)
+				buffer[i * outputs.size() + o] = outputs[o]->getVoltage() / 10.0f;
+		}
+		wav.write(buffer.data(), numFrames);
+	}
+	job.elapsedNs = bench::nowNs() - start;
+	if (!wav.close()) {
+		job.message = "unable to write " + job.wavPath;
+		return;
+	}
+	char buf[128];
+	snprintf(buf, sizeof(buf), "%i modules, %i cables, %.1fx real time, %.1f ns/sample", (int)patch.modules.size(), (int)patch.cables.size(), frames / (double)sampleRate / (job.elapsedNs * 1e-9), job.elapsedNs / frames);
+	job.message = buf;
+	job.ok = true;
+}
+
+
+int main(int argc, char **argv) {
+	float sampleRate = 44100.0f;
+	float seconds = 10.0f;
+	int numWorkers = 0;
+	std::string batchPath;
+	std::vector<RenderOutput> outputs;
+	std::vector<std::string> paths;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "-s" && i + 1 < argc)
+			sampleRate = (float)atof(argv[++i]);
+		else if (arg == "-l" && i + 1 < argc)
+			seconds = (float)atof(argv[++i]);
+		else if (arg == "-j" && i + 1 < argc)
+			numWorkers = atoi(argv[++i]);
+		else if (arg == "-b" && i + 1 < argc)
+			batchPath = argv[++i];
+		else if (arg == "-o" && i + 1 < argc) {
+			RenderOutput output;
+			if (!parseOutput(argv[++i], output)) {
+				usage();
+				return 1;
+			}
+			outputs.push_back(output);
+		}
+		else if (arg[0] == '-') {
+			usage();
+			return arg == "-h" ? 0 : 1;
+		}
+		else
+			paths.push_back(arg);
+	}
+	bool batch = !batchPath.empty();
+	if ((batch ? !paths.empty() || !outputs.empty() : paths.size() != 2 || outputs.empty()) || sampleRate <= 0.0f || seconds <= 0.0f || numWorkers < 0) {
+		usage();
+		return 1;
+	}
+
+	std::vector<RenderJob> jobs;
+	if (batch) {
+		if (!readBatch(batchPath, jobs))
+			return 1;
+	}
+	else {
+		RenderJob job;
+		job.patchPath = paths[0];
+		job.wavPath = paths[1];
+		job.outputs = outputs;
+		jobs.push_back(job);
+	}
+
+	// Shared state is set up once, before any worker runs
+	bench::getPlugin();
+	bench::setSampleRate(sampleRate);
+	long frames = (long)(seconds * sampleRate);
+
+	bench::WorkPool pool(batch ? numWorkers : 1);
+	for (RenderJob &job : jobs) {
+		RenderJob *jobPtr = &job;
+		pool.add([=]() {
+			render(*jobPtr, sampleRate, frames);
+		});
+	}
+	double start = bench::nowNs();
+	pool.run();
+	double elapsedNs = bench::nowNs() - start;
+
+	int failures = 0;
+	for (const RenderJob &job : jobs) {
+		if (job.ok)
+			printf("%s: %s\n", job.wavPath.c_str(), job.message.c_str());
+		else {
+			fprintf(stderr, "%s: %s\n", job.patchPath.c_str(), job.message.c_str());
+			failures++;
+		}
+	}
+	if (batch)
+		printf("%i of %i patches rendered in %.3f s on %i threads (%.1fx real time overall)\n", (int)jobs.size() - failures, (int)jobs.size(), elapsedNs * 1e-9, pool.getNumWorkers(), (jobs.size() - failures) * (double)seconds / (elapsedNs * 1e-9));
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: declared matrix of patch setups (connected ports, mode flags, knob values)
+//  Port and param indexes follow the enums in the module structs (see comments next to each mask).
+//  Inputs that toggle a mode on each edge (run, reset, bypass...) are left unconnected so that
+//  a scenario stays in the mode it declares.
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#include "Scenarios.hpp"
+
+
+namespace bench {
+
+const std::vector<Scenario> &getScenarios() {
+	static const std::vector<Scenario> scenarios = {
+		// BlackHoles: inputs IN 0-7, LEVELCV 8-15; outputs OUT 0-7, BLACKHOLE 8-9; params LEVEL 0-7
+		{"BlackHoles", "linear", ALL_PORTS, ALL_PORTS, "{\"isExponential0\": 0, \"isExponential1\": 0}", {{0, 0.5f}, {1, -0.5f}, {4, 0.25f}, {7, 0.75f}}},
+		{"BlackHoles", "exponential", ALL_PORTS, ALL_PORTS, "{\"isExponential0\": 1, \"isExponential1\": 1}", {{0, 0.5f}, {1, -0.5f}, {4, 0.25f}, {7, 0.75f}}},
+		{"BlackHoles", "cv-gen-wormhole", 0xFF00, ALL_PORTS, "{\"isExponential0\": 1, \"isExponential1\": 0, \"wormhole\": true}", {{0, 0.5f}, {5, -0.5f}}},
+		{"BlackHoles", "sums-only", ALL_PORTS, 0x300, "{}", {}},
+		{"BlackHoles", "ramps-16", ALL_PORTS, ALL_PORTS, "{\"isExponential0\": 1, \"isExponential1\": 0, \"paramBlockSize\": 16}", {{0, 0.5f}, {1, -0.5f}, {4, 0.25f}, {7, 0.75f}}},
+		{"BlackHoles", "throughput-32", ALL_PORTS, ALL_PORTS, "{\"isExponential0\": 1, \"isExponential1\": 0, \"throughputBlockSize\": 32}", {{0, 0.5f}, {1, -0.5f}, {4, 0.25f}, {7, 0.75f}}},
+
+		// Pulsars: inputs INA 0-7, INB 8, LFO 9-10, (VOID 11-12, REV 13-14); outputs OUTA 0, OUTB 1-8
+		{"Pulsars", "bipolar", 0x7FF, ALL_PORTS, "{\"cvMode0\": 0, \"cvMode1\": 0}", {}},
+		{"Pulsars", "all-random", 0x7FF, ALL_PORTS, "{\"cvMode0\": 2, \"cvMode1\": 2, \"isRandom0\": 1, \"isRandom1\": 1}", {}},
+		{"Pulsars", "void-2-inputs", 0x603, 0x7, "{\"isVoid0\": 1, \"isVoid1\": 1, \"cvMode0\": 1, \"cvMode1\": 1}", {}},
+
+		// Branes: inputs IN 0-13, TRIG 14-15, (TRIG_BYPASS 16-17, NOISE_RANGE 18-19); outputs OUT 0-13
+		{"Branes", "noise-all-outs", 0x0, ALL_PORTS, "{\"vibrations0\": 0, \"vibrations1\": 0}", {}},
+		{"Branes", "s&h-noise", 0xC000, ALL_PORTS, "{\"vibrations0\": 0, \"vibrations1\": 0}", {}},
+		{"Branes", "s&h-inputs", 0xFFFF, ALL_PORTS, "{\"vibrations0\": 0, \"vibrations1\": 0}", {}},
+		{"Branes", "yellow-blue", 0xC000, ALL_PORTS, "{\"vibrations0\": 2, \"vibrations1\": 3, \"noiseRange0\": 1, \"noiseRange1\": 1}", {}},
+		{"Branes", "two-outs", 0xC000, 0x81, "{\"vibrations0\": 0, \"vibrations1\": 0}", {}},
+		{"Branes", "throughput-32", 0xC0FF, ALL_PORTS, "{\"vibrations0\": 0, \"vibrations1\": 3, \"throughputBlockSize\": 32}", {}},
+
+		// Ions: inputs CLK 0, CLK_INPUTS 1-2, (RUN 3, RESET 4), PROB 5, (OCTCV 6-7, STATECV 8-9, LEAP 10, UNCERTANTY 11); outputs SEQ 0-1, JUMP 2-3
+		{"Ions", "global-clock", 0x1, ALL_PORTS, "{\"states0\": 0, \"states1\": 0}", {{17, 0.5f}}},
+		{"Ions", "local-uncertain", 0x27, ALL_PORTS, "{\"states0\": 2, \"states1\": 2, \"uncertainty\": true, \"leap\": true}", {{17, 0.5f}}},
+
+		// Entropia: inputs CERTAIN_CLK 0, UNCERTAIN_CLK 1, (LENGTH 2, RUN 3, RESET 4, STATESWITCH 5, SWITCHADD 6, OCTCV 7-8), EXTSIG 9-10, (QUANTIZE 11-12), GPROB 13; output CV 0
+		{"Entropia", "certain-cv", 0x1, ALL_PORTS, "{\"sources0\": 0, \"sources1\": 0, \"clkSource\": 0}", {}},
+		{"Entropia", "both-clocks-ext-audio", 0x2603, ALL_PORTS, "{\"sources0\": 1, \"sources1\": 1, \"audio\": 3, \"clkSource\": 0}", {}},
+		{"Entropia", "random-add", 0x3, ALL_PORTS, "{\"sources0\": 2, \"sources1\": 2, \"addMode\": true}", {}},
+
+		// Energy: inputs FREQCV 0-1, FREQCV_INPUT 2, MULTIPLY 3, MOMENTUM 4-5; params PLANCK 0-1, MODTYPE 2-3, ROUTING 4, FREQ 5-6, MOMENTUM 7-8, CROSS 9
+		{"Energy", "no-feedback", 0x4, ALL_PORTS, "{\"routing\": 1}", {{7, 0.0f}, {8, 0.0f}}},
+		{"Energy", "feedback-oversampled", 0x4, ALL_PORTS, "{\"routing\": 1}", {{7, 0.5f}, {8, 0.5f}}},
+		{"Energy", "quantized-cross", ALL_PORTS, ALL_PORTS, "{\"planck0\": 1, \"planck1\": 2, \"cross\": 1, \"routing\": 2}", {{5, 1.3f}, {7, 0.3f}, {8, 0.6f}}},
+		{"Energy", "feedback-ramps-16", 0x4, ALL_PORTS, "{\"routing\": 1, \"paramBlockSize\": 16}", {{7, 0.5f}, {8, 0.5f}}},
+
+		// Torus: inputs MIX 0-15; outputs MIX 0-6; params GAIN 0, MODE 1
+		{"Torus", "decay", ALL_PORTS, ALL_PORTS, "{\"mixmode\": 0}", {}},
+		{"Torus", "constant", ALL_PORTS, ALL_PORTS, "{\"mixmode\": 1}", {}},
+		{"Torus", "filter", ALL_PORTS, ALL_PORTS, "{\"mixmode\": 2}", {}},
+		{"Torus", "filter-sparse", 0x0101, ALL_PORTS, "{\"mixmode\": 2}", {}},
+		{"Torus", "decay-throughput-16", ALL_PORTS, ALL_PORTS, "{\"mixmode\": 0, \"throughputBlockSize\": 16}", {}},
+		{"Torus", "filter-throughput-32", ALL_PORTS, ALL_PORTS, "{\"mixmode\": 2, \"throughputBlockSize\": 32}", {}},
+
+		// Fate: inputs FREEWILL 0, CLOCK 1, MAIN 2, EXMACHINA 3, CHOICSDEPTH 4; output MAIN 0; params FREEWILL 0
+		{"Fate", "clocked", ALL_PORTS, ALL_PORTS, "{}", {{0, 0.5f}}},
+
+		// Blank-PanelLogo: output OUT 0
+		{"Blank-PanelLogo", "clock-out", 0x0, ALL_PORTS, "{}", {}},
+
+		{"Blank-PanelInfo", "idle", 0x0, 0x0, "{}", {}},
+	};
+	return scenarios;
+}
+
+
+bool scenarioMatches(const Scenario &scenario, const std::vector<std::string> &filters) {
+	if (filters.empty())
+		return true;
+	std::string full = std::string(scenario.slug) + "/" + scenario.name;
+	for (const std::string &filter : filters) {
+		if (filter == scenario.slug || full.compare(0, filter.size(), filter) == 0)
+			return true;
+	}
+	return false;
+}
+
+
+uint64_t scenarioSeed(const Scenario &scenario) {
+	// FNV-1a of "slug/name"
+	std::string full = std::string(scenario.slug) + "/" + scenario.name;
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for (char c : full) {
+		hash ^= (uint8_t)c;
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+}// namespace bench
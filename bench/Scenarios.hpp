@@ -0,0 +1,41 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: declared matrix of patch setups (connected ports, mode flags, knob values)
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#ifndef GEO_BENCH_SCENARIOS_HPP
+#define GEO_BENCH_SCENARIOS_HPP
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace bench {
+
+static const uint64_t ALL_PORTS = ~((uint64_t)0);
+
+struct Scenario {
+	const char *slug;// model slug
+	const char *name;
+	uint64_t inputMask;// bit i set means input i has a cable
+	uint64_t outputMask;// bit i set means output i has a cable
+	const char *json;// module state applied through dataFromJson(), this is how the mode flags are set
+	std::vector<std::pair<int, float>> params;// paramId, value
+};
+
+const std::vector<Scenario> &getScenarios();
+
+// True when filters is empty or when one of them is the scenario's slug or a prefix of "slug/name"
+bool scenarioMatches(const Scenario &scenario, const std::vector<std::string> &filters);
+
+// Seed for the random source of a scenario, derived from its name so that it does not depend on run order
+uint64_t scenarioSeed(const Scenario &scenario);
+
+}// namespace bench
+
+#endif
@@ -0,0 +1,132 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench shim: the non-inline parts of include/rack.hpp (string, random, context, assets)
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#include <cstdarg>
+#include "rack.hpp"
+
+
+namespace rack {
+
+
+// String
+
+namespace string {
+
+std::string f(const char *format, ...) {
+	va_list args;
+	va_start(args, format);
+	va_list argsCopy;
+	va_copy(argsCopy, args);
+	int size = vsnprintf(NULL, 0, format, argsCopy);
+	va_end(argsCopy);
+	std::string s(size > 0 ? size : 0, '\0');
+	if (size > 0)
+		vsnprintf(&s[0], size + 1, format, args);
+	va_end(args);
+	return s;
+}
+
+}// namespace string
+
+
+
+// Random (same generator and conversions as Rack's random.cpp)
+
+namespace random {
+
+// Thread-local like Rack's, so that patches rendered on different threads each have their own seeded sequence
+static thread_local uint64_t xoroshiro128plus_state[2] = {};
+
+static uint64_t rotl(const uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t xoroshiro128plus_next() {
+	const uint64_t s0 = xoroshiro128plus_state[0];
+	uint64_t s1 = xoroshiro128plus_state[1];
+	const uint64_t result = s0 + s1;
+	s1 ^= s0;
+	xoroshiro128plus_state[0] = rotl(s0, 55) ^ s1 ^ (s1 << 14);
+	xoroshiro128plus_state[1] = rotl(s1, 36);
+	return result;
+}
+
+void init() {
+	seed(0);
+}
+
+void seed(uint64_t s) {
+	// splitmix64 expansion so that any seed (including 0) gives a well mixed state
+	for (int i = 0; i < 2; i++) {
+		uint64_t z = (s += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		xoroshiro128plus_state[i] = z ^ (z >> 31);
+	}
+	// shift state a few times due to low seed entropy
+	for (int i = 0; i < 50; i++)
+		xoroshiro128plus_next();
+}
+
+uint32_t u32() {
+	return xoroshiro128plus_next() >> 32;
+}
+
+uint64_t u64() {
+	return xoroshiro128plus_next();
+}
+
+float uniform() {
+	return (xoroshiro128plus_next() >> (64 - 24)) / std::pow(2.0f, 24);
+}
+
+float normal() {
+	const float radius = std::sqrt(-2.0f * std::log(1.0f - uniform()));
+	const float theta = 2.0f * M_PI * uniform();
+	return radius * std::sin(theta);
+}
+
+}// namespace random
+
+
+// Context
+
+static Engine engine;
+static Window window;
+static Context context;
+
+Context *contextGet() {
+	if (!context.engine) {
+		context.engine = &engine;
+		context.window = &window;
+	}
+	return &context;
+}
+
+std::shared_ptr<Svg> Window::loadSvg(const std::string &filename) {
+	svgLoadCalls++;
+	std::shared_ptr<Svg> &svg = svgCache[filename];
+	if (!svg) {
+		svgCacheMisses++;
+		svg = std::make_shared<Svg>();
+		svg->path = filename;
+	}
+	return svg;
+}
+
+
+// Assets
+
+namespace asset {
+std::string plugin(Plugin *plugin, std::string filename) {
+	return filename;
+}
+}// namespace asset
+
+
+}// namespace rack
@@ -0,0 +1,74 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: streaming writer of 32 bit float WAV files
+//  Header fields are written little endian, as are the samples (the bench targets x86)
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#include "Wav.hpp"
+
+
+namespace bench {
+
+static void writeU32(FILE *file, uint32_t v) {
+	uint8_t bytes[4] = {(uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24)};
+	fwrite(bytes, 1, 4, file);
+}
+
+static void writeU16(FILE *file, uint16_t v) {
+	uint8_t bytes[2] = {(uint8_t)v, (uint8_t)(v >> 8)};
+	fwrite(bytes, 1, 2, file);
+}
+
+
+WavWriter::~WavWriter() {
+	close();
+}
+
+
+bool WavWriter::open(const std::string &path, int _channels, int sampleRate) {
+	file = fopen(path.c_str(), "wb");
+	if (!file)
+		return false;
+	channels = _channels;
+	frames = 0;
+	fwrite("RIFF", 1, 4, file);
+	writeU32(file, 0);// riff size, set by close()
+	fwrite("WAVE", 1, 4, file);
+	fwrite("fmt ", 1, 4, file);
+	writeU32(file, 16);
+	writeU16(file, 3);// WAVE_FORMAT_IEEE_FLOAT
+	writeU16(file, (uint16_t)channels);
+	writeU32(file, (uint32_t)sampleRate);
+	writeU32(file, (uint32_t)(sampleRate * channels * 4));// byte rate
+	writeU16(file, (uint16_t)(channels * 4));// block align
+	writeU16(file, 32);
+	fwrite("data", 1, 4, file);
+	writeU32(file, 0);// data size, set by close()
+	return true;
+}
+
+
+void WavWriter::write(const float *interleaved, long numFrames) {
+	fwrite(interleaved, sizeof(float), numFrames * channels, file);
+	frames += numFrames;
+}
+
+
+bool WavWriter::close() {
+	if (!file)
+		return true;
+	uint32_t dataSize = (uint32_t)(frames * channels * 4);
+	fseek(file, 4, SEEK_SET);
+	writeU32(file, 36 + dataSize);
+	fseek(file, 40, SEEK_SET);
+	writeU32(file, dataSize);
+	bool ret = ferror(file) == 0;
+	ret = (fclose(file) == 0) && ret;
+	file = NULL;
+	return ret;
+}
+
+}// namespace bench
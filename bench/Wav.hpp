@@ -0,0 +1,33 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: streaming writer of 32 bit float WAV files
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#ifndef GEO_BENCH_WAV_HPP
+#define GEO_BENCH_WAV_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+
+namespace bench {
+
+struct WavWriter {
+	FILE *file = NULL;
+	int channels = 0;
+	uint64_t frames = 0;
+
+	~WavWriter();
+
+	bool open(const std::string &path, int _channels, int sampleRate);
+	void write(const float *interleaved, long numFrames);
+	bool close();// writes the final sizes in the header
+};
+
+}// namespace bench
+
+#endif
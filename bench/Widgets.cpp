@@ -0,0 +1,79 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: construction cost of the module widgets (patch loading and module browser)
+//  The shim's widgets only keep the tree and the svg handles (no framebuffer or nanosvg parsing),
+//  so the times are those of the plugin's own widget code; the loadSvg() counts show how much
+//  parsing Rack does on top of it, since each cache miss there reads and parses a file.
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#include "Harness.hpp"
+#include "Widgets.hpp"
+
+
+namespace bench {
+
+static const int constructionsPerRepeat = 100;
+
+
+static void countWidgets(Widget *widget, int &widgets, int &transforms) {
+	widgets++;
+	if (dynamic_cast<TransformWidget*>(widget))
+		transforms++;
+	for (Widget *child : widget->children)
+		countWidgets(child, widgets, transforms);
+}
+
+
+// Best time in ns of one construction and deletion of the model's widget
+static double timeConstruction(Model *model, Module *module, int repeats) {
+	double best = 0.0;
+	for (int r = 0; r < repeats; r++) {
+		double start = nowNs();
+		for (int i = 0; i < constructionsPerRepeat; i++)
+			delete model->createModuleWidget(module);
+		double ns = (nowNs() - start) / constructionsPerRepeat;
+		if (r == 0 || ns < best)
+			best = ns;
+	}
+	return best;
+}
+
+
+int runWidgets(int repeats, const std::vector<std::string> &filters) {
+	printf("%-20s %12s %12s %8s %8s %8s %10s\n", "module", "ns w/module", "ns browser", "loadSvg", "cold", "widgets", "transforms");
+	int count = 0;
+	for (Model *model : getPlugin()->models) {
+		if (!filters.empty() && std::find(filters.begin(), filters.end(), model->slug) == filters.end())
+			continue;
+		Module *module = model->createModule();
+
+		// First construction with an empty svg cache, as when the first instance of a module is added
+		APP->window->svgCache.clear();
+		APP->window->svgLoadCalls = 0;
+		APP->window->svgCacheMisses = 0;
+		ModuleWidget *moduleWidget = model->createModuleWidget(module);
+		long loadCalls = APP->window->svgLoadCalls;
+		long cacheMisses = APP->window->svgCacheMisses;
+		int widgets = 0;
+		int transforms = 0;
+		countWidgets(moduleWidget, widgets, transforms);
+		delete moduleWidget;
+
+		double nsModule = timeConstruction(model, module, repeats);
+		double nsBrowser = timeConstruction(model, NULL, repeats);
+		delete module;
+
+		printf("%-20s %12.0f %12.0f %8li %8li %8i %10i\n", model->slug.c_str(), nsModule, nsBrowser, loadCalls, cacheMisses, widgets, transforms);
+		count++;
+	}
+	if (count == 0) {
+		fprintf(stderr, "no module matches\n");
+		return 1;
+	}
+	return 0;
+}
+
+}// namespace bench
@@ -0,0 +1,25 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: construction cost of the module widgets (patch loading and module browser)
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#ifndef GEO_BENCH_WIDGETS_HPP
+#define GEO_BENCH_WIDGETS_HPP
+
+#include <string>
+#include <vector>
+
+
+namespace bench {
+
+// Builds the widget of every model whose slug is in filters (all when empty) and prints the construction time
+//   with a module (patch loading) and without (module browser), the loadSvg() calls, the svgs that a cold cache
+//   has to parse and the size of the widget tree; returns the process exit code
+int runWidgets(int repeats, const std::vector<std::string> &filters);
+
+}// namespace bench
+
+#endif
@@ -0,0 +1,70 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: work-stealing thread pool for batch jobs (offline rendering of many patches)
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#include <thread>
+#include "WorkPool.hpp"
+
+
+namespace bench {
+
+WorkPool::WorkPool(int numWorkers) {
+	if (numWorkers <= 0)
+		numWorkers = std::max((int)std::thread::hardware_concurrency(), 1);
+	for (int i = 0; i < numWorkers; i++)
+		queues.emplace_back(new WorkerQueue);
+}
+
+
+void WorkPool::add(Job job) {
+	queues[nextQueue]->jobs.push_back(job);
+	nextQueue = (nextQueue + 1) % getNumWorkers();
+}
+
+
+bool WorkPool::takeJob(int worker, Job &job) {
+	// Own queue first, newest job
+	{
+		WorkerQueue &queue = *queues[worker];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.jobs.empty()) {
+			job = queue.jobs.back();
+			queue.jobs.pop_back();
+			return true;
+		}
+	}
+	// Steal the oldest job of the next non empty queue
+	for (int i = 1; i < getNumWorkers(); i++) {
+		WorkerQueue &queue = *queues[(worker + i) % getNumWorkers()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.jobs.empty()) {
+			job = queue.jobs.front();
+			queue.jobs.pop_front();
+			return true;
+		}
+	}
+	return false;// no job is added while running, so all queues stay empty from now on
+}
+
+
+void WorkPool::work(int worker) {
+	Job job;
+	while (takeJob(worker, job))
+		job();
+}
+
+
+void WorkPool::run() {
+	std::vector<std::thread> threads;
+	for (int i = 1; i < getNumWorkers(); i++)
+		threads.emplace_back(&WorkPool::work, this, i);
+	work(0);// the calling thread is worker 0
+	for (std::thread &thread : threads)
+		thread.join();
+}
+
+}// namespace bench
@@ -0,0 +1,48 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench: work-stealing thread pool for batch jobs (offline rendering of many patches)
+//  Jobs are dealt round-robin to one deque per worker. A worker takes from the back of its own
+//  deque and, once it is empty, steals from the front of the others, so that long and short
+//  jobs even out over the cores. Jobs are independent; run() returns when all of them are done.
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#ifndef GEO_BENCH_WORKPOOL_HPP
+#define GEO_BENCH_WORKPOOL_HPP
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace bench {
+
+struct WorkPool {
+	typedef std::function<void()> Job;
+
+	struct WorkerQueue {
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	std::vector<std::unique_ptr<WorkerQueue>> queues;
+
+	WorkPool(int numWorkers);// 0 is one worker per hardware thread
+
+	int getNumWorkers() {return (int)queues.size();}
+	void add(Job job);// before run()
+	void run();
+
+private:
+	int nextQueue = 0;
+	bool takeJob(int worker, Job &job);
+	void work(int worker);
+};
+
+}// namespace bench
+
+#endif
@@ -0,0 +1,11 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench shim: stands in for Rack's include/dsp/filter.hpp (nothing from it is used)
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#pragma once
+
+#include "rack.hpp"
@@ -0,0 +1,81 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench shim: the small subset of the jansson API used by the modules
+//  (object/number/boolean/string/array values, reference counting and a parser)
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#ifndef GEO_BENCH_JANSSON_H
+#define GEO_BENCH_JANSSON_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+
+typedef long long json_int_t;
+
+enum json_type {
+	JSON_OBJECT,
+	JSON_ARRAY,
+	JSON_STRING,
+	JSON_INTEGER,
+	JSON_REAL,
+	JSON_TRUE,
+	JSON_FALSE,
+	JSON_NULL
+};
+
+struct json_t;
+
+struct json_error_t {
+	int line;
+	int column;
+	char text[160];
+};
+
+
+json_t *json_object();
+json_t *json_array();
+json_t *json_string(const char *value);
+json_t *json_integer(json_int_t value);
+json_t *json_real(double value);
+json_t *json_true();
+json_t *json_false();
+json_t *json_null();
+inline json_t *json_boolean(bool value) {return value ? json_true() : json_false();}
+
+json_t *json_incref(json_t *json);
+void json_decref(json_t *json);
+
+json_type json_typeof(const json_t *json);
+inline bool json_is_object(const json_t *json) {return json && json_typeof(json) == JSON_OBJECT;}
+inline bool json_is_array(const json_t *json) {return json && json_typeof(json) == JSON_ARRAY;}
+inline bool json_is_string(const json_t *json) {return json && json_typeof(json) == JSON_STRING;}
+inline bool json_is_integer(const json_t *json) {return json && json_typeof(json) == JSON_INTEGER;}
+inline bool json_is_real(const json_t *json) {return json && json_typeof(json) == JSON_REAL;}
+inline bool json_is_number(const json_t *json) {return json_is_integer(json) || json_is_real(json);}
+inline bool json_is_true(const json_t *json) {return json && json_typeof(json) == JSON_TRUE;}
+inline bool json_is_false(const json_t *json) {return json && json_typeof(json) == JSON_FALSE;}
+inline bool json_is_boolean(const json_t *json) {return json_is_true(json) || json_is_false(json);}
+
+json_int_t json_integer_value(const json_t *json);
+double json_real_value(const json_t *json);
+double json_number_value(const json_t *json);
+const char *json_string_value(const json_t *json);
+
+int json_object_set_new(json_t *object, const char *key, json_t *value);
+int json_object_set(json_t *object, const char *key, json_t *value);
+json_t *json_object_get(const json_t *object, const char *key);
+size_t json_object_size(const json_t *object);
+
+int json_array_append_new(json_t *array, json_t *value);
+size_t json_array_size(const json_t *array);
+json_t *json_array_get(const json_t *array, size_t index);
+
+json_t *json_loads(const char *input, size_t flags, json_error_t *error);
+json_t *json_load_file(const char *path, size_t flags, json_error_t *error);
+
+#endif
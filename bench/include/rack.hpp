@@ -0,0 +1,759 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Headless bench shim: a stand-in for the part of the Rack v1 API that the Geodesics modules use,
+//  so that src/*.cpp can be compiled and driven without the Rack SDK, a window or an engine thread.
+//  Only the engine-facing behavior (params, ports, lights, sample rate, random) is modeled faithfully;
+//  widgets are inert containers and svg loading is a counting stub.
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#ifndef GEO_BENCH_RACK_HPP
+#define GEO_BENCH_RACK_HPP
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <emmintrin.h>
+#include <jansson.h>
+
+
+#define ENUMS(name, count) name, name ## _LAST = name + (count) - 1
+#define CHECKMARK_STRING "\xE2\x9C\x94"
+#define CHECKMARK(_cond) ((_cond) ? CHECKMARK_STRING : "")
+
+
+namespace rack {
+
+
+// ******** Math ********
+
+namespace math {
+
+inline int clamp(int x, int a, int b) {return std::max(std::min(x, b), a);}
+inline float clamp(float x, float a, float b) {return std::fmax(std::fmin(x, b), a);}
+inline float rescale(float x, float xMin, float xMax, float yMin, float yMax) {
+	return yMin + (x - xMin) / (xMax - xMin) * (yMax - yMin);
+}
+
+struct Vec {
+	float x = 0.0f;
+	float y = 0.0f;
+
+	Vec() {}
+	Vec(float _x, float _y) : x(_x), y(_y) {}
+	Vec neg() const {return Vec(-x, -y);}
+	Vec plus(Vec b) const {return Vec(x + b.x, y + b.y);}
+	Vec minus(Vec b) const {return Vec(x - b.x, y - b.y);}
+	Vec mult(float s) const {return Vec(x * s, y * s);}
+	Vec div(float s) const {return Vec(x / s, y / s);}
+};
+
+struct Rect {
+	Vec pos;
+	Vec size;
+
+	Rect() {}
+	Rect(Vec _pos, Vec _size) : pos(_pos), size(_size) {}
+	Vec getCenter() const {return pos.plus(size.mult(0.5f));}
+};
+
+}// namespace math
+
+using namespace math;
+
+
+// ******** String ********
+
+namespace string {
+
+std::string f(const char *format, ...);// printf-like formatting into a std::string
+
+}// namespace string
+
+
+// ******** Random ********
+
+namespace random {
+
+// xoroshiro128+ like Rack, with thread-local state; seedable so that renders are repeatable
+void init();
+void seed(uint64_t s);
+uint32_t u32();
+uint64_t u64();
+float uniform();
+float normal();
+
+}// namespace random
+
+
+// ******** SIMD ********
+
+// Subset of Rack's simd/vector.hpp and simd/functions.hpp (SSE, 4 float lanes)
+namespace simd {
+
+struct int32_4;
+
+struct float_4 {
+	union {
+		__m128 v;
+		float s[4];
+	};
+
+	float_4() {}
+	float_4(__m128 _v) : v(_v) {}
+	float_4(float x) : v(_mm_set1_ps(x)) {}
+	float_4(float x1, float x2, float x3, float x4) : v(_mm_setr_ps(x1, x2, x3, x4)) {}
+	explicit float_4(int32_4 a);// conversion, like Rack's
+	static float_4 cast(int32_4 a);// bits reinterpreted, like Rack's
+	static float_4 zero() {return float_4(_mm_setzero_ps());}
+	static float_4 mask() {return float_4(_mm_castsi128_ps(_mm_set1_epi32(-1)));}
+	static float_4 load(const float *x) {return float_4(_mm_loadu_ps(x));}
+	void store(float *x) {_mm_storeu_ps(x, v);}
+	float &operator[](int i) {return s[i];}
+	const float &operator[](int i) const {return s[i];}
+};
+
+inline float_4 operator+(float_4 a, float_4 b) {return float_4(_mm_add_ps(a.v, b.v));}
+inline float_4 operator-(float_4 a, float_4 b) {return float_4(_mm_sub_ps(a.v, b.v));}
+inline float_4 operator*(float_4 a, float_4 b) {return float_4(_mm_mul_ps(a.v, b.v));}
+inline float_4 operator/(float_4 a, float_4 b) {return float_4(_mm_div_ps(a.v, b.v));}
+inline float_4 operator-(float_4 a) {return float_4(_mm_sub_ps(_mm_setzero_ps(), a.v));}
+inline float_4 &operator+=(float_4 &a, float_4 b) {return a = a + b;}
+inline float_4 &operator-=(float_4 &a, float_4 b) {return a = a - b;}
+inline float_4 &operator*=(float_4 &a, float_4 b) {return a = a * b;}
+inline float_4 &operator/=(float_4 &a, float_4 b) {return a = a / b;}
+inline float_4 operator&(float_4 a, float_4 b) {return float_4(_mm_and_ps(a.v, b.v));}
+inline float_4 operator|(float_4 a, float_4 b) {return float_4(_mm_or_ps(a.v, b.v));}
+inline float_4 operator^(float_4 a, float_4 b) {return float_4(_mm_xor_ps(a.v, b.v));}
+inline float_4 operator~(float_4 a) {return a ^ float_4::mask();}
+inline float_4 operator==(float_4 a, float_4 b) {return float_4(_mm_cmpeq_ps(a.v, b.v));}
+inline float_4 operator!=(float_4 a, float_4 b) {return float_4(_mm_cmpneq_ps(a.v, b.v));}
+inline float_4 operator<(float_4 a, float_4 b) {return float_4(_mm_cmplt_ps(a.v, b.v));}
+inline float_4 operator<=(float_4 a, float_4 b) {return float_4(_mm_cmple_ps(a.v, b.v));}
+inline float_4 operator>(float_4 a, float_4 b) {return float_4(_mm_cmpgt_ps(a.v, b.v));}
+inline float_4 operator>=(float_4 a, float_4 b) {return float_4(_mm_cmpge_ps(a.v, b.v));}
+
+inline int movemask(float_4 a) {return _mm_movemask_ps(a.v);}// bit i set when the sign bit of lane i is set
+inline float_4 ifelse(float_4 mask, float_4 a, float_4 b) {return (mask & a) | float_4(_mm_andnot_ps(mask.v, b.v));}
+inline float_4 fmin(float_4 a, float_4 b) {return float_4(_mm_min_ps(a.v, b.v));}
+inline float_4 fmax(float_4 a, float_4 b) {return float_4(_mm_max_ps(a.v, b.v));}
+inline float_4 clamp(float_4 x, float_4 a, float_4 b) {return fmin(fmax(x, a), b);}
+inline float_4 fabs(float_4 a) {return float_4(_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v));}
+
+struct int32_4 {
+	union {
+		__m128i v;
+		int32_t s[4];
+	};
+
+	int32_4() {}
+	int32_4(__m128i _v) : v(_v) {}
+	int32_4(int32_t x) : v(_mm_set1_epi32(x)) {}
+	int32_4(int32_t x1, int32_t x2, int32_t x3, int32_t x4) : v(_mm_setr_epi32(x1, x2, x3, x4)) {}
+	explicit int32_4(float_4 a) : v(_mm_cvttps_epi32(a.v)) {}// conversion, like Rack's
+	static int32_4 cast(float_4 a) {return int32_4(_mm_castps_si128(a.v));}// bits reinterpreted, like Rack's
+	static int32_4 zero() {return int32_4(_mm_setzero_si128());}
+	static int32_4 load(const int32_t *x) {return int32_4(_mm_loadu_si128((const __m128i*)x));}
+	void store(int32_t *x) {_mm_storeu_si128((__m128i*)x, v);}
+	int32_t &operator[](int i) {return s[i];}
+	const int32_t &operator[](int i) const {return s[i];}
+};
+
+inline float_4::float_4(int32_4 a) : v(_mm_cvtepi32_ps(a.v)) {}
+inline float_4 float_4::cast(int32_4 a) {return float_4(_mm_castsi128_ps(a.v));}
+inline int32_4 operator+(int32_4 a, int32_4 b) {return int32_4(_mm_add_epi32(a.v, b.v));}
+inline int32_4 operator-(int32_4 a, int32_4 b) {return int32_4(_mm_sub_epi32(a.v, b.v));}
+inline int32_4 operator&(int32_4 a, int32_4 b) {return int32_4(_mm_and_si128(a.v, b.v));}
+inline int32_4 operator|(int32_4 a, int32_4 b) {return int32_4(_mm_or_si128(a.v, b.v));}
+inline int32_4 operator^(int32_4 a, int32_4 b) {return int32_4(_mm_xor_si128(a.v, b.v));}
+inline int32_4 &operator+=(int32_4 &a, int32_4 b) {return a = a + b;}
+inline int32_4 &operator&=(int32_4 &a, int32_4 b) {return a = a & b;}
+inline int32_4 &operator|=(int32_4 &a, int32_4 b) {return a = a | b;}
+inline int32_4 &operator^=(int32_4 &a, int32_4 b) {return a = a ^ b;}
+inline int32_4 operator<<(int32_4 a, int b) {return int32_4(_mm_sll_epi32(a.v, _mm_cvtsi32_si128(b)));}
+inline int32_4 operator>>(int32_4 a, int b) {return int32_4(_mm_sra_epi32(a.v, _mm_cvtsi32_si128(b)));}// arithmetic, like Rack's
+
+}// namespace simd
+
+
+// ******** DSP ********
+
+namespace dsp {
+
+struct SchmittTrigger {
+	enum State {
+		LOW,
+		HIGH,
+		UNKNOWN
+	};
+	State state;
+
+	SchmittTrigger() {reset();}
+	void reset() {state = UNKNOWN;}
+	bool process(float in) {
+		switch (state) {
+			case LOW:
+				if (in >= 1.0f) {
+					state = HIGH;
+					return true;
+				}
+				break;
+			case HIGH:
+				if (in <= 0.0f)
+					state = LOW;
+				break;
+			default:
+				if (in >= 1.0f)
+					state = HIGH;
+				else if (in <= 0.0f)
+					state = LOW;
+				break;
+		}
+		return false;
+	}
+	bool isHigh() {return state == HIGH;}
+};
+
+struct PulseGenerator {
+	float remaining = 0.0f;
+
+	void reset() {remaining = 0.0f;}
+	bool process(float deltaTime) {
+		if (remaining > 0.0f) {
+			remaining -= deltaTime;
+			return true;
+		}
+		return false;
+	}
+	void trigger(float duration = 1e-3f) {
+		if (duration > remaining)
+			remaining = duration;
+	}
+};
+
+}// namespace dsp
+
+
+// ******** Engine ********
+
+static const int PORT_MAX_CHANNELS = 16;
+
+struct Param {
+	float value = 0.0f;
+
+	float getValue() {return value;}
+	void setValue(float v) {value = v;}
+};
+
+struct ParamQuantity {
+	struct Module *module = NULL;
+	int paramId = 0;
+	float minValue = 0.0f;
+	float maxValue = 1.0f;
+	float defaultValue = 0.0f;
+	std::string label;
+	std::string unit;
+	float displayBase = 0.0f;
+	float displayMultiplier = 1.0f;
+	float displayOffset = 0.0f;
+
+	virtual ~ParamQuantity() {}
+};
+
+struct Port {
+	float voltages[PORT_MAX_CHANNELS] = {};
+	uint8_t channels = 0;
+
+	void setVoltage(float voltage, int channel = 0) {voltages[channel] = voltage;}
+	float getVoltage(int channel = 0) {return voltages[channel];}
+	void setChannels(int c) {channels = (uint8_t)c;}
+	int getChannels() {return channels;}
+	bool isConnected() {return channels > 0;}
+	float value() {return voltages[0];}
+};
+
+struct Input : Port {};
+struct Output : Port {};
+
+struct Light {
+	float value = 0.0f;
+
+	void setBrightness(float brightness) {
+		value = (brightness > 0.0f) ? brightness * brightness : 0.0f;
+	}
+	float getBrightness() {return std::sqrt(value);}
+	void setSmoothBrightness(float brightness, float deltaTime) {
+		float v = (brightness > 0.0f) ? brightness * brightness : 0.0f;
+		if (v < value) {
+			// Fade out light with lambda = framerate
+			value += (v - value) * 30.0f * deltaTime;
+		}
+		else {
+			// Immediately illuminate light
+			value = v;
+		}
+	}
+};
+
+struct Module {
+	int id = -1;
+	std::vector<Param> params;
+	std::vector<Input> inputs;
+	std::vector<Output> outputs;
+	std::vector<Light> lights;
+	std::vector<ParamQuantity*> paramQuantities;
+
+	struct ProcessArgs {
+		float sampleRate;
+		float sampleTime;
+	};
+
+	Module() {}
+	virtual ~Module() {
+		for (ParamQuantity *paramQuantity : paramQuantities)
+			delete paramQuantity;
+	}
+
+	void config(int numParams, int numInputs, int numOutputs, int numLights = 0) {
+		params.resize(numParams);
+		inputs.resize(numInputs);
+		outputs.resize(numOutputs);
+		lights.resize(numLights);
+		paramQuantities.resize(numParams, NULL);
+	}
+
+	template <class TParamQuantity = ParamQuantity>
+	void configParam(int paramId, float minValue, float maxValue, float defaultValue, std::string label = "", std::string unit = "", float displayBase = 0.0f, float displayMultiplier = 1.0f, float displayOffset = 0.0f) {
+		assert(paramId < (int)params.size());
+		delete paramQuantities[paramId];
+		ParamQuantity *q = new TParamQuantity;
+		q->module = this;
+		q->paramId = paramId;
+		q->minValue = minValue;
+		q->maxValue = maxValue;
+		q->defaultValue = defaultValue;
+		q->label = label;
+		q->unit = unit;
+		q->displayBase = displayBase;
+		q->displayMultiplier = displayMultiplier;
+		q->displayOffset = displayOffset;
+		paramQuantities[paramId] = q;
+		params[paramId].value = defaultValue;
+	}
+
+	virtual void process(const ProcessArgs &args) {}
+	virtual json_t *dataToJson() {return NULL;}
+	virtual void dataFromJson(json_t *rootJ) {}
+	virtual void onAdd() {}
+	virtual void onRemove() {}
+	virtual void onReset() {}
+	virtual void onRandomize() {}
+	virtual void onSampleRateChange() {}
+};
+
+struct Engine {
+	float sampleRate = 44100.0f;
+
+	float getSampleRate() {return sampleRate;}
+	float getSampleTime() {return 1.0f / sampleRate;}
+};
+
+
+// ******** Widgets (inert) ********
+
+struct Svg {
+	std::string path;
+};
+
+struct NVGcolor {
+	float r = 0.0f;
+	float g = 0.0f;
+	float b = 0.0f;
+	float a = 0.0f;
+};
+
+}// namespace rack
+
+
+typedef struct NVGcontext NVGcontext;
+
+inline rack::NVGcolor nvgRGBA(unsigned char r, unsigned char g, unsigned char b, unsigned char a) {
+	rack::NVGcolor c;
+	c.r = r / 255.0f;
+	c.g = g / 255.0f;
+	c.b = b / 255.0f;
+	c.a = a / 255.0f;
+	return c;
+}
+inline rack::NVGcolor nvgRGB(unsigned char r, unsigned char g, unsigned char b) {return nvgRGBA(r, g, b, 255);}
+inline void nvgBeginPath(NVGcontext *vg) {}
+inline void nvgCircle(NVGcontext *vg, float cx, float cy, float r) {}
+inline void nvgFillColor(NVGcontext *vg, rack::NVGcolor color) {}
+inline void nvgFill(NVGcontext *vg) {}
+inline void nvgStrokeWidth(NVGcontext *vg, float width) {}
+inline void nvgStrokeColor(NVGcontext *vg, rack::NVGcolor color) {}
+inline void nvgStroke(NVGcontext *vg) {}
+
+
+namespace rack {
+
+static const NVGcolor SCHEME_WHITE = nvgRGB(0xff, 0xff, 0xff);
+static const NVGcolor SCHEME_RED = nvgRGB(0xed, 0x2c, 0x24);
+static const NVGcolor SCHEME_YELLOW = nvgRGB(0xf9, 0xdf, 0x1c);
+static const NVGcolor SCHEME_BLUE = nvgRGB(0x29, 0xb2, 0xef);
+
+
+namespace event {
+struct Action {};
+}// namespace event
+
+
+struct Widget {
+	Rect box;
+	Widget *parent = NULL;
+	std::list<Widget*> children;
+
+	virtual ~Widget() {
+		for (Widget *child : children)
+			delete child;
+	}
+	void addChild(Widget *child) {
+		child->parent = this;
+		children.push_back(child);
+	}
+	void removeChild(Widget *child) {
+		children.remove(child);
+		child->parent = NULL;
+	}
+};
+
+struct TransformWidget : Widget {
+	float transform[6] = {1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f};
+
+	void translate(Vec delta) {
+		transform[4] += transform[0] * delta.x + transform[2] * delta.y;
+		transform[5] += transform[1] * delta.x + transform[3] * delta.y;
+	}
+	void rotate(float angle) {
+		float c = std::cos(angle);
+		float s = std::sin(angle);
+		float t[4] = {transform[0] * c + transform[2] * s, transform[1] * c + transform[3] * s,
+					  transform[2] * c - transform[0] * s, transform[3] * c - transform[1] * s};
+		std::copy(t, t + 4, transform);
+	}
+};
+
+struct FramebufferWidget : Widget {
+	bool dirty = true;
+};
+
+struct SvgWidget : Widget {
+	std::shared_ptr<Svg> svg;
+
+	void setSvg(std::shared_ptr<Svg> _svg) {svg = _svg;}
+};
+
+struct CircularShadow : Widget {
+	float blurRadius = 0.0f;
+	float opacity = 0.15f;
+};
+
+struct ParamWidget : Widget {
+	ParamQuantity *paramQuantity = NULL;
+};
+
+struct PortWidget : Widget {
+	Module *module = NULL;
+	int portId = 0;
+	enum Type {
+		OUTPUT,
+		INPUT
+	};
+	Type type = INPUT;
+};
+
+struct SvgPort : PortWidget {
+	FramebufferWidget *fb;
+	CircularShadow *shadow;
+	SvgWidget *sw;
+
+	SvgPort() {
+		fb = new FramebufferWidget;
+		addChild(fb);
+		shadow = new CircularShadow;
+		fb->addChild(shadow);
+		sw = new SvgWidget;
+		fb->addChild(sw);
+	}
+	void setSvg(std::shared_ptr<Svg> svg) {sw->setSvg(svg);}
+};
+
+struct SvgSwitch : ParamWidget {
+	FramebufferWidget *fb;
+	CircularShadow *shadow;
+	SvgWidget *sw;
+	std::vector<std::shared_ptr<Svg>> frames;
+	bool momentary = false;
+
+	SvgSwitch() {
+		fb = new FramebufferWidget;
+		addChild(fb);
+		shadow = new CircularShadow;
+		fb->addChild(shadow);
+		sw = new SvgWidget;
+		fb->addChild(sw);
+	}
+	void addFrame(std::shared_ptr<Svg> svg) {
+		frames.push_back(svg);
+		if (!sw->svg)
+			sw->setSvg(svg);
+	}
+};
+
+struct SvgKnob : ParamWidget {
+	FramebufferWidget *fb;
+	CircularShadow *shadow;
+	TransformWidget *tw;
+	SvgWidget *sw;
+	float minAngle = -M_PI;
+	float maxAngle = M_PI;
+
+	SvgKnob() {
+		fb = new FramebufferWidget;
+		addChild(fb);
+		shadow = new CircularShadow;
+		fb->addChild(shadow);
+		tw = new TransformWidget;
+		fb->addChild(tw);
+		sw = new SvgWidget;
+		tw->addChild(sw);
+	}
+	void setSvg(std::shared_ptr<Svg> svg) {sw->setSvg(svg);}
+};
+
+struct LightWidget : Widget {
+	NVGcolor bgColor;
+	NVGcolor color;
+	NVGcolor borderColor;
+
+	virtual void drawLight(NVGcontext *vg) {}
+};
+
+struct ModuleLightWidget : LightWidget {
+	Module *module = NULL;
+	int firstLightId = 0;
+	std::vector<NVGcolor> baseColors;
+
+	void addBaseColor(NVGcolor baseColor) {baseColors.push_back(baseColor);}
+};
+
+template <typename TBase>
+struct SmallLight : TBase {
+	SmallLight() {this->box.size = Vec(6.0f, 6.0f);}
+};
+
+struct Menu : Widget {};
+
+struct MenuEntry : Widget {};
+
+struct MenuLabel : MenuEntry {
+	std::string text;
+};
+
+struct MenuItem : MenuEntry {
+	std::string text;
+	std::string rightText;
+
+	virtual void onAction(event::Action &e) {}
+};
+
+struct Quantity {
+	virtual ~Quantity() {}
+	virtual void setValue(float value) {}
+	virtual float getValue() {return 0.0f;}
+	virtual float getMinValue() {return 0.0f;}
+	virtual float getMaxValue() {return 1.0f;}
+	virtual float getDefaultValue() {return 0.0f;}
+	virtual std::string getLabel() {return "";}
+	virtual std::string getUnit() {return "";}
+	virtual std::string getDisplayValueString() {return string::f("%g", getValue());}
+};
+
+struct Slider : Widget {
+	Quantity *quantity = NULL;// not owned, like Rack's
+};
+
+struct ModuleWidget : Widget {
+	Module *module = NULL;
+	Widget *panel = NULL;
+	std::vector<ParamWidget*> params;
+	std::vector<PortWidget*> inputs;
+	std::vector<PortWidget*> outputs;
+
+	virtual ~ModuleWidget() {}// the module is owned by the caller, not by the widget in the bench
+	void setModule(Module *_module) {module = _module;}
+	void setPanel(std::shared_ptr<Svg> svg) {
+		SvgWidget *sw = new SvgWidget;
+		sw->setSvg(svg);
+		panel = sw;
+		addChild(panel);
+		box.size = Vec(15.0f * 12.0f, 380.0f);// RACK_GRID_HEIGHT; widths are panel dependent in Rack
+	}
+	void addParam(ParamWidget *param) {
+		params.push_back(param);
+		addChild(param);
+	}
+	void addInput(PortWidget *input) {
+		inputs.push_back(input);
+		addChild(input);
+	}
+	void addOutput(PortWidget *output) {
+		outputs.push_back(output);
+		addChild(output);
+	}
+	virtual void appendContextMenu(Menu *menu) {}
+};
+
+
+// ******** Plugin and models ********
+
+struct Plugin;
+
+struct Model {
+	Plugin *plugin = NULL;
+	std::string slug;
+
+	virtual ~Model() {}
+	virtual Module *createModule() = 0;
+	virtual ModuleWidget *createModuleWidget(Module *module) = 0;// module can be NULL like in the module browser
+};
+
+struct Plugin {
+	std::string slug = "Geodesics";
+	std::vector<Model*> models;
+
+	void addModel(Model *model) {
+		model->plugin = this;
+		models.push_back(model);
+	}
+	Model *getModel(const std::string &slug) {
+		for (Model *model : models)
+			if (model->slug == slug)
+				return model;
+		return NULL;
+	}
+};
+
+template <class TModule, class TModuleWidget>
+Model *createModel(std::string slug) {
+	struct TModel : Model {
+		Module *createModule() override {
+			return new TModule;
+		}
+		ModuleWidget *createModuleWidget(Module *module) override {
+			TModule *tm = NULL;
+			if (module) {
+				tm = dynamic_cast<TModule*>(module);
+				assert(tm);
+			}
+			return new TModuleWidget(tm);
+		}
+	};
+	TModel *o = new TModel;
+	o->slug = slug;
+	return o;
+}
+
+template <class TWidget>
+TWidget *createWidgetCentered(Vec pos) {
+	TWidget *o = new TWidget;
+	o->box.pos = pos.minus(o->box.size.div(2.0f));
+	return o;
+}
+
+template <class TParamWidget>
+TParamWidget *createParamCentered(Vec pos, Module *module, int paramId) {
+	TParamWidget *o = createWidgetCentered<TParamWidget>(pos);
+	if (module)
+		o->paramQuantity = module->paramQuantities[paramId];
+	return o;
+}
+
+template <class TPortWidget>
+TPortWidget *createInputCentered(Vec pos, Module *module, int inputId) {
+	TPortWidget *o = createWidgetCentered<TPortWidget>(pos);
+	o->module = module;
+	o->type = PortWidget::INPUT;
+	o->portId = inputId;
+	return o;
+}
+
+template <class TPortWidget>
+TPortWidget *createOutputCentered(Vec pos, Module *module, int outputId) {
+	TPortWidget *o = createWidgetCentered<TPortWidget>(pos);
+	o->module = module;
+	o->type = PortWidget::OUTPUT;
+	o->portId = outputId;
+	return o;
+}
+
+template <class TModuleLightWidget>
+TModuleLightWidget *createLightCentered(Vec pos, Module *module, int firstLightId) {
+	TModuleLightWidget *o = createWidgetCentered<TModuleLightWidget>(pos);
+	o->module = module;
+	o->firstLightId = firstLightId;
+	return o;
+}
+
+template <class TMenuItem = MenuItem>
+TMenuItem *createMenuItem(std::string text, std::string rightText = "") {
+	TMenuItem *o = new TMenuItem;
+	o->text = text;
+	o->rightText = rightText;
+	return o;
+}
+
+
+// ******** Application context ********
+
+struct Window {
+	// Cached by filename like in Rack, where a cache miss parses the file; the counters are read by the widget bench
+	std::map<std::string, std::shared_ptr<Svg>> svgCache;
+	long svgLoadCalls = 0;
+	long svgCacheMisses = 0;
+
+	std::shared_ptr<Svg> loadSvg(const std::string &filename);
+};
+
+struct Context {
+	Engine *engine = NULL;
+	Window *window = NULL;
+};
+
+Context *contextGet();
+
+namespace asset {
+std::string plugin(Plugin *plugin, std::string filename);
+}// namespace asset
+
+
+}// namespace rack
+
+
+#define APP rack::contextGet()
+
+
+void init(rack::Plugin *p);
+
+
+#endif
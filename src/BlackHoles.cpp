@@ -45,6 +45,8 @@ struct BlackHoles : Module {
 	
 	// Need to save, no reset
 	int panelTheme;
+	ParamRamps<8> levels;// levels of the channels after CV and exponential curve, blockSize is saved
+	ThroughputBlock<8, 10> throughput;// inputs IN, outputs OUT and BLACKHOLE; blockSize is saved
 	
 	// Need to save, with reset
 	bool isExponential[2];
@@ -52,13 +54,14 @@ struct BlackHoles : Module {
 	int cvMode;// 0 is -5v to 5v, 1 is -10v to 10v; bit 0 is upper BH, bit 1 is lower BH
 	
 	// No need to save, with reset
-	// none
+	typedef void (BlackHoles::*HolesKernel)();
+	HolesKernel holesKernel;// processHoles() of the wormhole mode, set by updateKernels()
+	HolesKernel holesBlockKernel;// processHolesBlock() of the wormhole mode, idem
 	
 	// No need to save, no reset
-	Trigger expTriggers[2];
-	Trigger cvLevelTriggers[2];
-	Trigger wormholeTrigger;
-	RefreshCounter refresh;
+	TriggerBank<5> buttonTriggers;// exponential 0-1, cv level 2-3, wormhole 4
+	ConnectionMasks connections;
+	RefreshCounter refresh{52.0f, 94.0f};
 
 	
 	BlackHoles() {
@@ -89,6 +92,9 @@ struct BlackHoles : Module {
 		isExponential[1] = false;
 		wormhole = true;
 		cvMode = 0x3;
+		levels.reset();
+		throughput.reset();
+		updateKernels();
 		// resetNonJson
 	}
 	// void resetNonJson() {
@@ -101,6 +107,7 @@ struct BlackHoles : Module {
 			isExponential[i] = (random::u32() % 2) > 0;
 		}
 		wormhole = (random::u32() % 2) > 0;
+		updateKernels();
 	}
 
 	
@@ -110,6 +117,12 @@ struct BlackHoles : Module {
 		// panelTheme
 		json_object_set_new(rootJ, "panelTheme", json_integer(panelTheme));
 
+		// paramBlockSize
+		json_object_set_new(rootJ, "paramBlockSize", json_integer(levels.blockSize));
+
+		// throughputBlockSize
+		json_object_set_new(rootJ, "throughputBlockSize", json_integer(throughput.blockSize));
+
 		// isExponential
 		json_object_set_new(rootJ, "isExponential0", json_real(isExponential[0]));
 		json_object_set_new(rootJ, "isExponential1", json_real(isExponential[1]));
@@ -130,6 +143,16 @@ struct BlackHoles : Module {
 		if (panelThemeJ)
 			panelTheme = json_integer_value(panelThemeJ);
 
+		// paramBlockSize
+		json_t *paramBlockSizeJ = json_object_get(rootJ, "paramBlockSize");
+		if (paramBlockSizeJ)
+			levels.blockSize = ParamRamps<8>::normalizeBlockSize(json_integer_value(paramBlockSizeJ));
+
+		// throughputBlockSize
+		json_t *throughputBlockSizeJ = json_object_get(rootJ, "throughputBlockSize");
+		if (throughputBlockSizeJ)
+			throughput.blockSize = ThroughputBlock<8, 10>::normalizeBlockSize(json_integer_value(throughputBlockSizeJ));
+
 		// isExponential
 		json_t *isExponential0J = json_object_get(rootJ, "isExponential0");
 		if (isExponential0J)
@@ -148,59 +171,71 @@ struct BlackHoles : Module {
 		if (cvModeJ)
 			cvMode = json_integer_value(cvModeJ);
 		
+		updateKernels();
 		// resetNonJson();
 	}
 
 	
+#ifdef GEO_PROCESS_TIMING
+	ProcessTimeHistogram processTimes{this};
+#endif
+	
+	void onConnectionsChanged(const ConnectionMasks &oldMasks, const ConnectionMasks &newMasks) {
+		// nothing to rebuild, process() reads the masks directly
+	}
+	
+	
 	void process(const ProcessArgs &args) override {
+#ifdef GEO_PROCESS_TIMING
+		ProcessTimer processTimer(processTimes);
+#endif
+		DenormalGuard denormalGuard;
 		if (refresh.processInputs()) {
+			for (int i = 0; i < 2; i++) {
+				buttonTriggers.values[0 + i] = params[EXP_PARAMS + i].getValue();
+				buttonTriggers.values[2 + i] = params[CVLEVEL_PARAMS + i].getValue();
+			}
+			buttonTriggers.values[4] = params[WORMHOLE_PARAM].getValue();
+			uint32_t buttonTrigs = buttonTriggers.process();
+			
 			// Exponential buttons
 			for (int i = 0; i < 2; i++)
-				if (expTriggers[i].process(params[EXP_PARAMS + i].getValue())) {
+				if ((buttonTrigs & (0x1 << (0 + i))) != 0) {
 					isExponential[i] = !isExponential[i];
 			}
 			
 			// Wormhole buttons
-			if (wormholeTrigger.process(params[WORMHOLE_PARAM].getValue())) {
+			if ((buttonTrigs & (0x1 << 4)) != 0) {
 				wormhole = ! wormhole;
+				updateKernels();
 			}
 
 			// CV Level buttons
 			for (int i = 0; i < 2; i++) {
-				if (cvLevelTriggers[i].process(params[CVLEVEL_PARAMS + i].getValue()))
+				if ((buttonTrigs & (0x1 << (2 + i))) != 0)
 					cvMode ^= (0x1 << i);
 			}
 		}// userInputs refresh
+		connections.process(this, refresh.processInputs());
 		
-		// BlackHole 0 all outputs
-		float blackHole0 = 0.0f;
-		float inputs0[4] = {10.0f, 10.0f, 10.0f, 10.0f};// default to generate CV when no input connected
-		for (int i = 0; i < 4; i++) 
-			if (inputs[IN_INPUTS + i].isConnected())
-				inputs0[i] = inputs[IN_INPUTS + i].getVoltage();
-		for (int i = 0; i < 4; i++) {
-			float chanVal = calcChannel(inputs0[i], params[LEVEL_PARAMS + i], inputs[LEVELCV_INPUTS + i], isExponential[0], cvMode & 0x1);
-			outputs[OUT_OUTPUTS + i].setVoltage(chanVal);
-			blackHole0 += chanVal;
+		if (throughput.sync(&outputs[OUT_OUTPUTS])) {
+			// Throughput mode, the outputs are one block late
+			for (int i = 0; i < 8; i++)
+				throughput.ins[i][throughput.pos] = inputs[IN_INPUTS + i].getVoltage();
+			if (throughput.next(&outputs[OUT_OUTPUTS]))
+				(this->*holesBlockKernel)();
 		}
-		outputs[BLACKHOLE_OUTPUTS + 0].setVoltage(clamp(blackHole0, -10.0f, 10.0f));
-			
+		else {
+			// Channel levels, at control rate
+			if (levels.isBlockStart()) {
+				calcLevelTargets();
+				levels.start();
+			}
+			levels.next();
 			
-		// BlackHole 1 all outputs
-		float blackHole1 = 0.0f;
-		float inputs1[4] = {10.0f, 10.0f, 10.0f, 10.0f};// default to generate CV when no input connected
-		for (int i = 0; i < 4; i++) {
-			if (inputs[IN_INPUTS + i + 4].isConnected())
-				inputs1[i] = inputs[IN_INPUTS + i + 4].getVoltage();
-			else if (wormhole)
-				inputs1[i] = blackHole0;
+			// BlackHole outputs
+			(this->*holesKernel)();
 		}
-		for (int i = 0; i < 4; i++) {
-			float chanVal = calcChannel(inputs1[i], params[LEVEL_PARAMS + i + 4], inputs[LEVELCV_INPUTS + i + 4], isExponential[1], cvMode >> 1);
-			outputs[OUT_OUTPUTS + i + 4].setVoltage(chanVal);
-			blackHole1 += chanVal;
-		}
-		outputs[BLACKHOLE_OUTPUTS + 1].setVoltage(clamp(blackHole1, -10.0f, 10.0f));
 
 		// lights
 		if (refresh.processLights()) {
@@ -223,22 +258,115 @@ struct BlackHoles : Module {
 		
 	}// step()
 	
-	inline float calcChannel(float in, Param &level, Input &levelCV, bool isExp, int cvMode) {
-		float levCv = levelCV.isConnected() ? (levelCV.getVoltage() * (cvMode != 0 ? 0.1f : 0.2f)) : 0.0f;
-		float lev = clamp(level.getValue() + levCv, -1.0f, 1.0f);
-		if (isExp) {
-			float newlev = rescale(std::pow(expBase, std::fabs(lev)), 1.0f, expBase, 0.0f, 1.0f);
-			if (lev < 0.0f)
-				newlev *= -1.0f;
-			lev = newlev;
+	void updateKernels() {// call when wormhole changes
+		holesKernel = wormhole ? &BlackHoles::processHoles<true> : &BlackHoles::processHoles<false>;
+		holesBlockKernel = wormhole ? &BlackHoles::processHolesBlock<true> : &BlackHoles::processHolesBlock<false>;
+	}
+	
+	void calcLevelTargets() {
+		for (int i = 0; i < 8; i++)
+			levels.targets[i] = calcLevel(params[LEVEL_PARAMS + i], inputs[LEVELCV_INPUTS + i], connections.isInputConnected(LEVELCV_INPUTS + i), (cvMode >> (i >> 2)) & 0x1);
+		for (int i = 0; i < 2; i++) {
+			if (isExponential[i])
+				calcExpLevels(simd::float_4::load(&levels.targets[i * 4])).store(&levels.targets[i * 4]);
 		}
-		float ret = lev * in;
-		return ret;
+	}
+	
+	// Channel and black hole outputs, instantiated for both wormhole modes and chosen by updateKernels(), so that the
+	//   mode is not tested per sample (the exponential and cv modes are only used with the levels at control rate)
+	template<bool WORMHOLE>
+	void processHoles() {
+		// BlackHole 0 all outputs
+		float blackHole0 = 0.0f;
+		float inputs0[4] = {10.0f, 10.0f, 10.0f, 10.0f};// default to generate CV when no input connected
+		for (int i = 0; i < 4; i++) 
+			if (connections.isInputConnected(IN_INPUTS + i))
+				inputs0[i] = inputs[IN_INPUTS + i].getVoltage();
+		for (int i = 0; i < 4; i++) {
+			float chanVal = levels.get(i) * inputs0[i];
+			outputs[OUT_OUTPUTS + i].setVoltage(chanVal);
+			blackHole0 += chanVal;
+		}
+		outputs[BLACKHOLE_OUTPUTS + 0].setVoltage(clamp(blackHole0, -10.0f, 10.0f));
+			
+			
+		// BlackHole 1 all outputs
+		float blackHole1 = 0.0f;
+		float inputs1[4] = {10.0f, 10.0f, 10.0f, 10.0f};// default to generate CV when no input connected
+		for (int i = 0; i < 4; i++) {
+			if (connections.isInputConnected(IN_INPUTS + i + 4))
+				inputs1[i] = inputs[IN_INPUTS + i + 4].getVoltage();
+			else if (WORMHOLE)
+				inputs1[i] = blackHole0;
+		}
+		for (int i = 0; i < 4; i++) {
+			float chanVal = levels.get(i + 4) * inputs1[i];
+			outputs[OUT_OUTPUTS + i + 4].setVoltage(chanVal);
+			blackHole1 += chanVal;
+		}
+		outputs[BLACKHOLE_OUTPUTS + 1].setVoltage(clamp(blackHole1, -10.0f, 10.0f));
+	}
+	
+	// Block kernel of processHoles() for the throughput mode, on the inputs collected in throughput.ins[], 4 samples per
+	//   vector; the levels are evaluated once per block and ramped over it
+	template<bool WORMHOLE>
+	void processHolesBlock() {
+		int size = throughput.size;
+		calcLevelTargets();
+		levels.start(size);
+		for (int s = 0; s < size; s += 4) {
+			simd::float_4 n = simd::float_4(1.0f, 2.0f, 3.0f, 4.0f) + (float)s;// next() calls of the samples
+			
+			// BlackHole 0 all outputs
+			simd::float_4 blackHole0 = simd::float_4::zero();
+			for (int i = 0; i < 4; i++) {
+				simd::float_4 in = connections.isInputConnected(IN_INPUTS + i) ? simd::float_4::load(&throughput.ins[i][s]) : simd::float_4(10.0f);
+				simd::float_4 chanVal = (levels.get(i) + levels.getStep(i) * n) * in;
+				chanVal.store(&throughput.outs[OUT_OUTPUTS + i][s]);
+				blackHole0 += chanVal;
+			}
+			simd::clamp(blackHole0, -10.0f, 10.0f).store(&throughput.outs[BLACKHOLE_OUTPUTS + 0][s]);
+			
+			// BlackHole 1 all outputs
+			simd::float_4 blackHole1 = simd::float_4::zero();
+			for (int i = 0; i < 4; i++) {
+				simd::float_4 in = WORMHOLE ? blackHole0 : simd::float_4(10.0f);
+				if (connections.isInputConnected(IN_INPUTS + i + 4))
+					in = simd::float_4::load(&throughput.ins[i + 4][s]);
+				simd::float_4 chanVal = (levels.get(i + 4) + levels.getStep(i + 4) * n) * in;
+				chanVal.store(&throughput.outs[OUT_OUTPUTS + i + 4][s]);
+				blackHole1 += chanVal;
+			}
+			simd::clamp(blackHole1, -10.0f, 10.0f).store(&throughput.outs[BLACKHOLE_OUTPUTS + 1][s]);
+		}
+		levels.skip(size);
+	}
+	
+	inline float calcLevel(Param &level, Input &levelCV, bool levelCVConnected, int cvMode) {
+		float levCv = levelCVConnected ? (levelCV.getVoltage() * (cvMode != 0 ? 0.1f : 0.2f)) : 0.0f;
+		return clamp(level.getValue() + levCv, -1.0f, 1.0f);
+	}
+	
+	inline simd::float_4 calcExpLevels(simd::float_4 lev) {// the 4 levels of a black hole
+		simd::float_4 newlev = (fastPow(expBase, simd::fabs(lev)) - 1.0f) * (1.0f / (expBase - 1.0f));// rescale 1..expBase to 0..1
+		return simd::ifelse(lev < 0.0f, -newlev, newlev);
 	}	
 };
 
 
 struct BlackHolesWidget : ModuleWidget {
+	void appendContextMenu(Menu *menu) override {
+		BlackHoles *module = dynamic_cast<BlackHoles*>(this->module);
+		assert(module);
+		
+		appendParamBlockSizeMenu(menu, &module->levels.blockSize);
+		appendThroughputMenu(menu, &module->throughput.blockSize, module->throughput.getLatency());
+		
+#ifdef GEO_PROCESS_TIMING
+		appendProcessTimesMenu(menu, module);
+#endif
+	}
+	
 	BlackHolesWidget(BlackHoles *module) {
 		setModule(module);
 
@@ -42,12 +42,26 @@ struct BlankInfo : Module {
 	}
 
 	
+#ifdef GEO_PROCESS_TIMING
+	ProcessTimeHistogram processTimes{this};
+#endif
+	
 	void process(const ProcessArgs &args) override {
+#ifdef GEO_PROCESS_TIMING
+		ProcessTimer processTimer(processTimes);
+#endif
+		DenormalGuard denormalGuard;
 	}
 };
 
 
 struct BlankInfoWidget : ModuleWidget {
+#ifdef GEO_PROCESS_TIMING
+	void appendContextMenu(Menu *menu) override {
+		appendProcessTimesMenu(menu, module);
+	}
+	
+#endif
 	BlankInfoWidget(BlankInfo *module) {
 		setModule(module);
 
@@ -17,7 +17,7 @@ struct LowFrequencyOscillator {
 	LowFrequencyOscillator() {}
 	void setPitch(float pitch) {
 		pitch = std::fmin(pitch, 8.0f);
-		freq = std::pow(2.0f, pitch);
+		freq = fastExp2(pitch);
 	}
 	void step(float dt) {
 		float deltaPhase = std::fmin(freq * dt, 0.5f);
@@ -115,7 +115,15 @@ struct BlankLogo : Module {
 	}
 
 	
+#ifdef GEO_PROCESS_TIMING
+	ProcessTimeHistogram processTimes{this};
+#endif
+	
 	void process(const ProcessArgs &args) override {
+#ifdef GEO_PROCESS_TIMING
+		ProcessTimer processTimer(processTimes);
+#endif
+		DenormalGuard denormalGuard;
 		if (outputs[OUT_OUTPUT].isConnected()) {
 			// CLK
 			oscillatorClk.setPitch(params[CLK_FREQ_PARAM].getValue());
@@ -134,6 +142,12 @@ struct BlankLogo : Module {
 
 
 struct BlankLogoWidget : ModuleWidget {
+#ifdef GEO_PROCESS_TIMING
+	void appendContextMenu(Menu *menu) override {
+		appendProcessTimesMenu(menu, module);
+	}
+	
+#endif
 	BlankLogoWidget(BlankLogo *module) {
 		setModule(module);
 
@@ -34,11 +34,10 @@ struct PinkNoise {
 	(This is pk3 = (Black) Paul Kellet's refined method in Allan's analysis.)
 	*/
 	
-	float b0, b1, b2, b3, b4, b5, b6;
+	// 4 generators in SIMD lanes
+	simd::float_4 b0 = 0.0f, b1 = 0.0f, b2 = 0.0f, b3 = 0.0f, b4 = 0.0f, b5 = 0.0f, b6 = 0.0f;
 
-	float process() {
-		// noise source
-		const float white = random::uniform() * 1.2f - 0.6f;// values adjusted so that returned pink noise is in -5V to +5V range
+	simd::float_4 process(simd::float_4 white) {// white noise source in -0.6 to 0.6, values adjusted so that returned pink noise is in -5V to +5V range
 		
 		// filter
 		b0 = 0.99886f * b0 + white * 0.0555179f;
@@ -47,7 +46,7 @@ struct PinkNoise {
 		b3 = 0.86650f * b3 + white * 0.3104856f;
 		b4 = 0.55000f * b4 + white * 0.5329522f;
 		b5 = -0.7616f * b5 - white * 0.0168980f;
-		const float pink = b0 + b1 + b2 + b3 + b4 + b5 + b6 + white * 0.5362f;
+		const simd::float_4 pink = b0 + b1 + b2 + b3 + b4 + b5 + b6 + white * 0.5362f;
 		b6 = white * 0.115926f;
 		return pink;
 	}
@@ -61,78 +60,52 @@ struct NoiseEngine {
 	enum NoiseId {NONE, WHITE, PINK, RED, BLUE};//use negative value for inv phase
 	int noiseSources[14] = {PINK, RED, BLUE, WHITE, BLUE, RED, PINK,   PINK, RED, BLUE, WHITE, BLUE, RED, PINK};
 
-
-	PinkNoise pinkNoise[2];
-	PinkNoise pinkForBlueNoise[2];
-	OnePoleFilter redFilter[2];// for lowpass
-	OnePoleFilter blueFilter[2];// for highpass
-	bool cacheHitRed[2];// no need to init; index is braneIndex
-	float cacheValRed[2];
-	bool cacheHitBlue[2];// no need to init; index is braneIndex
-	float cacheValBlue[2];
-	bool cacheHitPink[2];// no need to init; index is braneIndex
-	float cacheValPink[2];
-	
-	
-	float whiteNoise() {
-		return random::uniform() * 10.0f - 5.0f;
-	}	
+	// all colors of both branes are generated together once per sample, 4 lanes at a time
+	PinkNoise pinkNoise;// lanes: pink of brane 0 and 1, pink for blue of brane 0 and 1
+	OnePoleFilterBank<4> colorFilters;// lanes: red (lowpass of white) of brane 0 and 1, blue (highpass of pink) of brane 0 and 1
+	float noiseVals[5][2];// index is NoiseId then braneIndex, values of the current sample
+	bool cacheHit[5][2];// a color's second output in a brane gets the inverted phase
+	GeoRandom *rng = NULL;// the module's generator
 	
 	
 	void setCutoffs(float sampleRate) {
-		redFilter[0].setCutoff(70.0f / sampleRate);// low pass
-		redFilter[1].setCutoff(70.0f / sampleRate);
-		blueFilter[0].setCutoff(4410.0f / sampleRate);// high pass
-		blueFilter[1].setCutoff(4410.0f / sampleRate);
+		colorFilters.setCutoff(0, 70.0f / sampleRate);// low pass
+		colorFilters.setCutoff(1, 70.0f / sampleRate);
+		colorFilters.setCutoff(2, 4410.0f / sampleRate);// high pass
+		colorFilters.setCutoff(3, 4410.0f / sampleRate);
 	}		
 	
 	
-	void clearCache() {
-		// optimizations for noise generators
+	void process() {
+		simd::float_4 whites = rng->bipolar4();
+		process(whites, rng->bipolar4());
+	}
+	void process(simd::float_4 whites, simd::float_4 pinkWhites) {// white noises in [-1, 1), drawn in this order
+		whites *= 5.0f;// lanes: white of brane 0 and 1, white for red of brane 0 and 1
+		simd::float_4 pinks = pinkNoise.process(pinkWhites * 0.6f);
+		colorFilters.process(0, simd::float_4(whites[2], whites[3], pinks[2], pinks[3]));
+		simd::float_4 reds = colorFilters.lowpass(0) * 5.0f;
+		simd::float_4 blues = colorFilters.highpass(0) * 5.8f;
 		for (int i = 0; i < 2; i++) {
-			cacheHitRed[i] = false;
-			cacheHitBlue[i] = false;
-			cacheHitPink[i] = false;
+			noiseVals[WHITE][i] = whites[i];
+			noiseVals[PINK][i] = pinks[i];
+			noiseVals[RED][i] = reds[i];
+			noiseVals[BLUE][i] = blues[2 + i];
+			cacheHit[PINK][i] = false;
+			cacheHit[RED][i] = false;
+			cacheHit[BLUE][i] = false;
 		}
 	}		
 	
 	
 	float getNoise(int sh) {
-		float ret = 0.0f;
 		int braneIndex = sh < 7 ? 0 : 1;
 		int noiseIndex = noiseSources[sh];
-		if (noiseIndex == WHITE) {
-			ret = whiteNoise();
-		}
-		else if (noiseIndex == RED) {
-			if (cacheHitRed[braneIndex])
-				ret = -1.0f * cacheValRed[braneIndex];
-			else {
-				cacheValRed[braneIndex] = 5.0f * redFilter[braneIndex].process(whiteNoise());
-				cacheHitRed[braneIndex] = true;
-				ret = cacheValRed[braneIndex];
-			}
-		}
-		else if (noiseIndex == PINK) {
-			if (cacheHitPink[braneIndex])
-				ret = -1.0f * cacheValPink[braneIndex];
-			else {
-				cacheValPink[braneIndex] = pinkNoise[braneIndex].process();
-				cacheHitPink[braneIndex] = true;
-				ret = cacheValPink[braneIndex];
-			}
-		}
-		else {// noiseIndex == BLUE
-			if (cacheHitBlue[braneIndex])
-				ret = -1.0f * cacheValBlue[braneIndex];
-			else {
-				float pinkForBlue = pinkForBlueNoise[braneIndex].process();			
-				pinkForBlue -= blueFilter[braneIndex].process(pinkForBlue);// (input - lowpass) technique is used to make the highpass
-				cacheValBlue[braneIndex] = 5.8f * pinkForBlue;
-				cacheHitBlue[braneIndex] = true;
-				ret = cacheValBlue[braneIndex];
-			}
+		if (noiseIndex == WHITE) {// only one per brane
+			return noiseVals[WHITE][braneIndex];
 		}
+		float ret = cacheHit[noiseIndex][braneIndex] ? -1.0f * noiseVals[noiseIndex][braneIndex] : noiseVals[noiseIndex][braneIndex];
+		cacheHit[noiseIndex][braneIndex] = true;
 		return ret;
 	}		
 };
@@ -173,6 +146,8 @@ struct Branes : Module {
 	
 	// Need to save, no reset
 	int panelTheme;
+	GeoRandom rng;
+	ThroughputBlock<16, 14> throughput;// inputs IN and TRIG, outputs OUT; blockSize is saved
 	
 	// Need to save, with reset
 	int vibrations[2];
@@ -180,13 +155,15 @@ struct Branes : Module {
 	
 	// No need to save, with reset
 	float heldOuts[14];
+	ConnectionMasks connections;
+	int connectedInBits;// brane 0 is lsbit, brane 13 is bit 13, rebuilt when cables change
+	int connectedOutBits;// idem
 	
 	// No need to save, no reset
-	Trigger sampleTriggers[2];
-	Trigger trigBypassTriggers[2];
-	Trigger noiseRangeTriggers[2];
+	TriggerBank<2> sampleTriggers;
+	TriggerBank<4> buttonTriggers;// trig bypass 0-1, noise range 2-3
 	float trigLights[2] = {0.0f, 0.0f};
-	RefreshCounter refresh;
+	RefreshCounter refresh{0.0f, 80.0f};
 	HoldDetect secretHoldDetect[2];
 	NoiseEngine noiseEngine;
 	
@@ -200,6 +177,8 @@ struct Branes : Module {
 		configParam(NOISE_RANGE_PARAMS + 1, 0.0f, 1.0f, 0.0f, "Bottom brane noise range");		
 		
 		noiseEngine.setCutoffs(APP->engine->getSampleRate());
+		noiseEngine.rng = &rng;
+		rng.seed(random::u64());
 		
 		onReset();
 
@@ -217,6 +196,16 @@ struct Branes : Module {
 	void resetNonJson() {
 		for (int i = 0; i < 14; i++)
 			heldOuts[i] = 0.0f;
+		connections.reset();
+		connectedInBits = 0;
+		connectedOutBits = 0;
+		throughput.reset();
+	}
+	
+	
+	void onConnectionsChanged(const ConnectionMasks &oldMasks, const ConnectionMasks &newMasks) {
+		connectedInBits = (int)(newMasks.inputs >> IN_INPUTS) & 0x3FFF;
+		connectedOutBits = (int)(newMasks.outputs >> OUT_OUTPUTS) & 0x3FFF;
 	}
 
 	
@@ -236,6 +225,9 @@ struct Branes : Module {
 		// panelTheme
 		json_object_set_new(rootJ, "panelTheme", json_integer(panelTheme));
 
+		// throughputBlockSize
+		json_object_set_new(rootJ, "throughputBlockSize", json_integer(throughput.blockSize));
+
 		// trigBypass (DEPRECATED, replaced by vibrations below)
 		//json_object_set_new(rootJ, "trigBypass0", json_real(trigBypass[0]));// should have been bool instead of real
 		//json_object_set_new(rootJ, "trigBypass1", json_real(trigBypass[1]));// should have been bool instead of real
@@ -248,6 +240,9 @@ struct Branes : Module {
 		json_object_set_new(rootJ, "noiseRange0", json_real(noiseRange[0]));
 		json_object_set_new(rootJ, "noiseRange1", json_real(noiseRange[1]));
 
+		// randomSeed
+		json_object_set_new(rootJ, "randomSeed", rng.seedToJson());
+
 		return rootJ;
 	}
 
@@ -258,6 +253,11 @@ struct Branes : Module {
 		if (panelThemeJ)
 			panelTheme = json_integer_value(panelThemeJ);
 
+		// throughputBlockSize
+		json_t *throughputBlockSizeJ = json_object_get(rootJ, "throughputBlockSize");
+		if (throughputBlockSizeJ)
+			throughput.blockSize = ThroughputBlock<16, 14>::normalizeBlockSize(json_integer_value(throughputBlockSizeJ));
+
 		// vibrations (0 - top)
 		json_t *vibrations0J = json_object_get(rootJ, "vibrations0");
 		if (vibrations0J)
@@ -285,6 +285,9 @@ struct Branes : Module {
 		if (noiseRange1J)
 			noiseRange[1] = json_number_value(noiseRange1J);
 
+		// randomSeed
+		rng.seedFromJson(json_object_get(rootJ, "randomSeed"));
+
 		resetNonJson();
 	}
 
@@ -294,13 +297,30 @@ struct Branes : Module {
 	}		
 
 	
+#ifdef GEO_PROCESS_TIMING
+	ProcessTimeHistogram processTimes{this};
+#endif
+#ifdef GEO_DENORMAL_COUNT
+	DenormalCounters denormalCounts{this, {"pink b0-b6", "red/blue lowout"}};
+#endif
+	
 	void process(const ProcessArgs &args) override {
+#ifdef GEO_PROCESS_TIMING
+		ProcessTimer processTimer(processTimes);
+#endif
+		DenormalGuard denormalGuard;
 		static const float holdDetectTime = 2.0f;// seconds
 
 		if (refresh.processInputs()) {
+			for (int i = 0; i < 2; i++) {
+				buttonTriggers.values[0 + i] = params[TRIG_BYPASS_PARAMS + i].getValue() + inputs[TRIG_BYPASS_INPUTS + i].getVoltage();
+				buttonTriggers.values[2 + i] = params[NOISE_RANGE_PARAMS + i].getValue() + inputs[NOISE_RANGE_INPUTS + i].getVoltage();
+			}
+			uint32_t buttonTrigs = buttonTriggers.process();
+			
 			// vibrations buttons and cv inputs
 			for (int i = 0; i < 2; i++) {
-				if (trigBypassTriggers[i].process(params[TRIG_BYPASS_PARAMS + i].getValue() + inputs[TRIG_BYPASS_INPUTS + i].getVoltage())) {
+				if ((buttonTrigs & (0x1 << (0 + i))) != 0) {
 					vibrations[i] ^= 0x1;
 					secretHoldDetect[i].start((long) (holdDetectTime * args.sampleRate / RefreshCounter::displayRefreshStepSkips));
 				}
@@ -308,32 +328,165 @@ struct Branes : Module {
 			
 			// noiseRange buttons and cv inputs
 			for (int i = 0; i < 2; i++) {
-				if (noiseRangeTriggers[i].process(params[NOISE_RANGE_PARAMS + i].getValue() + inputs[NOISE_RANGE_INPUTS + i].getVoltage())) {
+				if ((buttonTrigs & (0x1 << (2 + i))) != 0) {
 					noiseRange[i] = !noiseRange[i];
 				}
 			}
 		}// userInputs refresh
-
-		// trig inputs
-		bool trigs[2];
-		for (int i = 0; i < 2; i++)	{	
-			trigs[i] = sampleTriggers[i].process(inputs[TRIG_INPUTS + i].getVoltage());
-			if (trigs[i])
-				trigLights[i] = 1.0f;
+		connections.process(this, refresh.processInputs());
+
+		if (throughput.sync(&outputs[OUT_OUTPUTS])) {
+			// Throughput mode, the outputs are one block late
+			for (int i = 0; i < 16; i++)
+				throughput.ins[i][throughput.pos] = inputs[IN_INPUTS + i].getVoltage();
+			if (throughput.next(&outputs[OUT_OUTPUTS]))
+				processBlock();
+		}
+		else {
+			// trig inputs
+			sampleTriggers.values[0] = inputs[TRIG_INPUTS + 0].getVoltage();
+			sampleTriggers.values[1] = inputs[TRIG_INPUTS + 1].getVoltage();
+			uint32_t sampleTrigs = sampleTriggers.process();
+			
+			// prepare triggering info for the sample and hold + noise code below
+			bool trigInConnect[2];
+			int hasTrigSourceBits = calcTrigSources(trigInConnect);
+			int receivedTrigBits = calcReceivedTrigs(sampleTrigs, trigInConnect);
+			
+			// main branes code
+			// -----------------------
+			
+			// sample and hold outputs (noise continually generated or else stepping non-white on S&H only will not work well because of filters)
+			if (connectedOutBits != 0) {
+				noiseEngine.process();
+#ifdef GEO_DENORMAL_COUNT
+				checkNoiseDenormals();
+#endif
+			}
+			for (int sh = 0; sh < 14; sh++) {
+				if ((connectedOutBits & (0x1 << sh)) != 0) {
+					float noise = getNoise(sh);// must call even if won't get used below so that proper noise is produced when s&h colored noise
+					if ((hasTrigSourceBits & (0x1 << sh)) != 0) {
+						if ((receivedTrigBits & (0x1 << sh)) != 0) {
+							if ((connectedInBits & (0x1 << sh)) != 0)// if input cable
+								heldOuts[sh] = inputs[IN_INPUTS + sh].getVoltage();// sample and hold input
+							else
+								heldOuts[sh] = noise; // sample and hold noise
+						}
+						// else no rising edge, so simply preserve heldOuts[sh], nothing to do
+					}
+					else { // no trig connected
+						if ((connectedInBits & (0x1 << sh)) != 0)
+							heldOuts[sh] = inputs[IN_INPUTS + sh].getVoltage();// copy of input if no trig and input
+						else
+							heldOuts[sh] = noise; // continuous noise if no trig and no input
+					}
+					outputs[OUT_OUTPUTS + sh].setVoltage(heldOuts[sh]);
+				}
+			}
 		}
 		
+		if (refresh.processLights()) {
+			// Lights
+			for (int i = 0; i < 2; i++) {
+				float blue = (vibrations[i] == 3 ? 1.0f : 0.0f);
+				float yellow = (vibrations[i] == 2 ? 1.0f : 0.0f);
+				float red = (vibrations[i] == 1 ? 1.0f : 0.0f);
+				float white = (vibrations[i] == 0 ? trigLights[i] : 0.0f);
+				trigLights[i] = 0.0f;
+				lights[BYPASS_TRIG_LIGHTS + i * 4 + 3].setSmoothBrightness(white, (float)args.sampleTime * (RefreshCounter::displayRefreshStepSkips >> 2));
+				lights[BYPASS_TRIG_LIGHTS + i * 4 + 2].setBrightness(red);
+				lights[BYPASS_TRIG_LIGHTS + i * 4 + 1].setBrightness(yellow);
+				lights[BYPASS_TRIG_LIGHTS + i * 4 + 0].setBrightness(blue);
+				lights[NOISE_RANGE_LIGHTS + i].setBrightness(noiseRange[i] ? 1.0f : 0.0f);
+				
+				if (secretHoldDetect[i].process(params[TRIG_BYPASS_PARAMS + i].getValue())) {
+					if (vibrations[i] > 1) 
+						vibrations[i] = 0;
+					else
+						vibrations[i] = 2;
+				}
+			}
+			
+		}// lightRefreshCounter
 		
-		// prepare triggering info for the sample and hold + noise code below
-		// -----------------------
+	}// step()
+	
+	// Block kernel of the sample and holds for the throughput mode, on the inputs collected in throughput.ins[]: the
+	//   triggers and the noise of the whole block are done first, then each output is run over the block. The random
+	//   choices of the yellow and blue vibrations are thus drawn before the noise of the block, unlike per sample
+	void processBlock() {
+		int size = throughput.size;
+		bool trigInConnect[2];
+		int hasTrigSourceBits = calcTrigSources(trigInConnect);
 		
-		bool trigInConnect[2];// incorporates bypass mechanism (vibrations < 2)
-		trigInConnect[0] = (vibrations[0] == 1 ? false : inputs[TRIG_INPUTS + 0].isConnected());
-		trigInConnect[1] = (vibrations[1] == 1 ? false : inputs[TRIG_INPUTS + 1].isConnected());
+		// trig inputs
+		int receivedTrigBits[ThroughputBlock<16, 14>::MAX_BLOCK_SIZE];
+		for (int s = 0; s < size; s++) {
+			sampleTriggers.values[0] = throughput.ins[TRIG_INPUTS + 0][s];
+			sampleTriggers.values[1] = throughput.ins[TRIG_INPUTS + 1][s];
+			receivedTrigBits[s] = calcReceivedTrigs(sampleTriggers.process(), trigInConnect);
+		}
+		
+		// noise continually generated, see process()
+		float noises[14][ThroughputBlock<16, 14>::MAX_BLOCK_SIZE];
+		if (connectedOutBits != 0) {
+			float whites[8 * ThroughputBlock<16, 14>::MAX_BLOCK_SIZE];// the two draws of NoiseEngine::process() for each sample
+			rng.fillBipolar(whites, 8 * size);
+			for (int s = 0; s < size; s++) {
+				noiseEngine.process(simd::float_4::load(&whites[8 * s]), simd::float_4::load(&whites[8 * s + 4]));
+				for (int sh = 0; sh < 14; sh++) {
+					if ((connectedOutBits & (0x1 << sh)) != 0)
+						noises[sh][s] = getNoise(sh);
+				}
+			}
+#ifdef GEO_DENORMAL_COUNT
+			checkNoiseDenormals();
+#endif
+		}
+		
+		// sample and hold outputs
+		for (int sh = 0; sh < 14; sh++) {
+			if ((connectedOutBits & (0x1 << sh)) == 0)
+				continue;
+			const float *in = ((connectedInBits & (0x1 << sh)) != 0) ? throughput.ins[IN_INPUTS + sh] : noises[sh];
+			float *out = throughput.outs[OUT_OUTPUTS + sh];
+			if ((hasTrigSourceBits & (0x1 << sh)) != 0) {
+				float held = heldOuts[sh];
+				for (int s = 0; s < size; s++) {
+					if ((receivedTrigBits[s] & (0x1 << sh)) != 0)
+						held = in[s];
+					out[s] = held;
+				}
+				heldOuts[sh] = held;
+			}
+			else {// no trig connected, copy of input or continuous noise
+				for (int s = 0; s < size; s++)
+					out[s] = in[s];
+				heldOuts[sh] = in[size - 1];
+			}
+		}
+	}
+	
+	int calcTrigSources(bool *trigInConnect) {// returns the outputs that have a trigger source, as bits
+		// incorporates bypass mechanism (vibrations < 2)
+		trigInConnect[0] = (vibrations[0] == 1 ? false : connections.isInputConnected(TRIG_INPUTS + 0));
+		trigInConnect[1] = (vibrations[1] == 1 ? false : connections.isInputConnected(TRIG_INPUTS + 1));
 		
 		// The 0x2000 bit in the next line is to cross trigger the top left of BraneB with trigger of BraneA
 		int hasTrigSourceBits = (trigInConnect[0] ? 0x207F : 0x0);// brane 0 is lsbit, brane 13 is bit 13
 		// The 0x0040 bit in the next line is to cross trigger the lower right of BraneA with trigger of BraneB
 		hasTrigSourceBits |= (trigInConnect[1] ? 0x3FC0 : 0x0);
+		return hasTrigSourceBits;
+	}
+	
+	int calcReceivedTrigs(uint32_t sampleTrigs, bool *trigInConnect) {// returns the outputs that sample, as bits
+		bool trigs[2];
+		for (int i = 0; i < 2; i++)	{	
+			trigs[i] = (sampleTrigs & (0x1 << i)) != 0;
+			if (trigs[i])
+				trigLights[i] = 1.0f;
+		}
 		
 		int receivedTrigBits = 0x0;// brane 0 is lsbit, brane 13 is bit 13
 		for (int bi = 0; bi < 2; bi++) {// brane index
@@ -347,12 +500,12 @@ struct Branes : Module {
 					int cnt = 0;
 					int connectedIndexes[7] = {0};
 					for (int i = 7 * bi; i < (7 * bi + 7); i++) {
-						if (outputs[OUT_OUTPUTS + i].isConnected()) {
+						if ((connectedOutBits & (0x1 << i)) != 0) {
 							connectedIndexes[cnt++] = i;
 						}
 					}
 					if (cnt > 0) {
-						int selected = random::u32() % cnt;	
+						int selected = rng.u32() % cnt;	
 						receivedTrigBits |= (0x1 << (connectedIndexes[selected]));
 					}
 				}
@@ -360,8 +513,8 @@ struct Branes : Module {
 			else {// vibrations[bi] == 3 // blue mode (each active active out has 50% chance to get the trigger)
 				if (trigs[bi] && trigInConnect[bi]) {
 					for (int i = 7 * bi; i < (7 * bi + 7); i++) {
-						if (outputs[OUT_OUTPUTS + i].isConnected()) {
-							receivedTrigBits |= ((random::u32() % 2) << i);
+						if ((connectedOutBits & (0x1 << i)) != 0) {
+							receivedTrigBits |= ((rng.u32() % 2) << i);
 						}
 					}
 				}
@@ -374,60 +527,18 @@ struct Branes : Module {
 		if (trigs[1] && trigInConnect[1]) {
 			receivedTrigBits |= 0x0040;
 		}
-
-		
-		// main branes code
-		// -----------------------
-		
-		// sample and hold outputs (noise continually generated or else stepping non-white on S&H only will not work well because of filters)
-		noiseEngine.clearCache();
-		for (int sh = 0; sh < 14; sh++) {
-			if (outputs[OUT_OUTPUTS + sh].isConnected()) {
-				float noise = getNoise(sh);// must call even if won't get used below so that proper noise is produced when s&h colored noise
-				if ((hasTrigSourceBits & (0x1 << sh)) != 0) {
-					if ((receivedTrigBits & (0x1 << sh)) != 0) {
-						if (inputs[IN_INPUTS + sh].isConnected())// if input cable
-							heldOuts[sh] = inputs[IN_INPUTS + sh].getVoltage();// sample and hold input
-						else
-							heldOuts[sh] = noise; // sample and hold noise
-					}
-					// else no rising edge, so simply preserve heldOuts[sh], nothing to do
-				}
-				else { // no trig connected
-					if (inputs[IN_INPUTS + sh].isConnected())
-						heldOuts[sh] = inputs[IN_INPUTS + sh].getVoltage();// copy of input if no trig and input
-					else
-						heldOuts[sh] = noise; // continuous noise if no trig and no input
-				}
-				outputs[OUT_OUTPUTS + sh].setVoltage(heldOuts[sh]);
-			}
-		}
-		
-		if (refresh.processLights()) {
-			// Lights
-			for (int i = 0; i < 2; i++) {
-				float blue = (vibrations[i] == 3 ? 1.0f : 0.0f);
-				float yellow = (vibrations[i] == 2 ? 1.0f : 0.0f);
-				float red = (vibrations[i] == 1 ? 1.0f : 0.0f);
-				float white = (vibrations[i] == 0 ? trigLights[i] : 0.0f);
-				trigLights[i] = 0.0f;
-				lights[BYPASS_TRIG_LIGHTS + i * 4 + 3].setSmoothBrightness(white, (float)args.sampleTime * (RefreshCounter::displayRefreshStepSkips >> 2));
-				lights[BYPASS_TRIG_LIGHTS + i * 4 + 2].setBrightness(red);
-				lights[BYPASS_TRIG_LIGHTS + i * 4 + 1].setBrightness(yellow);
-				lights[BYPASS_TRIG_LIGHTS + i * 4 + 0].setBrightness(blue);
-				lights[NOISE_RANGE_LIGHTS + i].setBrightness(noiseRange[i] ? 1.0f : 0.0f);
-				
-				if (secretHoldDetect[i].process(params[TRIG_BYPASS_PARAMS + i].getValue())) {
-					if (vibrations[i] > 1) 
-						vibrations[i] = 0;
-					else
-						vibrations[i] = 2;
-				}
-			}
-			
-		}// lightRefreshCounter
-		
-	}// step()
+		return receivedTrigBits;
+	}
+	
+#ifdef GEO_DENORMAL_COUNT
+	void checkNoiseDenormals() {
+		PinkNoise &pink = noiseEngine.pinkNoise;
+		simd::float_4 pinkStates[7] = {pink.b0, pink.b1, pink.b2, pink.b3, pink.b4, pink.b5, pink.b6};
+		for (int i = 0; i < 7; i++)
+			denormalCounts.check(0, pinkStates[i]);
+		denormalCounts.check(1, noiseEngine.colorFilters.lowout[0]);
+	}
+#endif
 	
 	float getNoise(int sh) {
 		float ret = noiseEngine.getNoise(sh);
@@ -481,6 +592,12 @@ struct BranesWidget : ModuleWidget {
 		secretItemL->module = module;
 		secretItemL->braneIndex = 1;
 		menu->addChild(secretItemL);
+		
+		appendThroughputMenu(menu, &module->throughput.blockSize, module->throughput.getLatency());
+		
+#ifdef GEO_PROCESS_TIMING
+		appendProcessTimesMenu(menu, module);
+#endif
 	}	
 	
 	BranesWidget(Branes *module) {
@@ -52,10 +52,11 @@ struct Energy : Module {
 	
 	// Need to save, no reset
 	int panelTheme;
+	ParamRamps<4> controls;// freq knobs 0-1, feedbacks 2-3, blockSize is saved
 	
 	// Need to save, with reset
-	FMOp* oscM;
-	FMOp* oscC;
+	FMOp oscM;
+	FMOp oscC;
 	int routing;// routing of knob 1. 
 		// 0 is independant (i.e. blue only) (bottom light, light index 0),
 		// 1 is control (i.e. blue and yellow) (top light, light index 1),
@@ -65,15 +66,13 @@ struct Energy : Module {
 	int cross;// cross momentum active or not
 	
 	// No need to save, with reset
-	// none
+	typedef void (Energy::*ModKernel)(const float *freqKnobs, float *modSignals);
+	ModKernel modKernel;// calcModSignals() of the routing and modtypes, set by updateKernels()
 	
 	// No need to save, no reset
-	RefreshCounter refresh;
+	RefreshCounter refresh{42.0f, 60.0f};
 	float feedbacks[2] = {0.0f, 0.0f};
-	Trigger routingTrigger;
-	Trigger planckTriggers[2];
-	Trigger modtypeTriggers[2];
-	Trigger crossTrigger;
+	TriggerBank<6> buttonTriggers;// planck 0-1, modtype 2-3, routing 4, cross 5
 	SlewLimiter multiplySlew;
 	
 	
@@ -91,8 +90,6 @@ struct Energy : Module {
 		configParam(Energy::MODTYPE_PARAMS + 0, 0.0f, 1.0f, 0.0f, "CV mod type M");
 		configParam(Energy::MODTYPE_PARAMS + 1, 0.0f, 1.0f, 0.0f, "CV mod type C");		
 		
-		oscM = new FMOp(APP->engine->getSampleRate());
-		oscC = new FMOp(APP->engine->getSampleRate());
 		onSampleRateChange();
 		onReset();
 
@@ -100,21 +97,17 @@ struct Energy : Module {
 	}
 	
 	
-	~Energy() {
-		delete oscM;
-		delete oscC;
-	}
-
-	
 	void onReset() override {
-		oscM->onReset();
-		oscC->onReset();
+		oscM.onReset();
+		oscC.onReset();
 		routing = 1;// default is control (i.e. blue and yellow) (top light, light index 1),
 		for (int i = 0; i < 2; i++) {
 			plancks[i] = 0;
 			modtypes[i] = 1;// default is add mode
 		}
 		cross = 0;
+		controls.reset();
+		updateKernels();
 		// resetNonJson();
 	}
 	// void resetNonJson() {
@@ -128,8 +121,8 @@ struct Energy : Module {
 
 	void onSampleRateChange() override {
 		float sampleRate = APP->engine->getSampleRate();
-		oscM->onSampleRateChange(sampleRate);
-		oscC->onSampleRateChange(sampleRate);
+		oscM.onSampleRateChange(sampleRate);
+		oscC.onSampleRateChange(sampleRate);
 		multiplySlew.setParams2(sampleRate, 2.5f, 20.0f, 1.0f);
 	}
 	
@@ -140,9 +133,12 @@ struct Energy : Module {
 		// panelTheme
 		json_object_set_new(rootJ, "panelTheme", json_integer(panelTheme));
 
+		// paramBlockSize
+		json_object_set_new(rootJ, "paramBlockSize", json_integer(controls.blockSize));
+
 		// oscM and oscC
-		oscM->dataToJson(rootJ, "oscM_");
-		oscC->dataToJson(rootJ, "oscC_");
+		oscM.dataToJson(rootJ, "oscM_");
+		oscC.dataToJson(rootJ, "oscC_");
 
 		// routing
 		json_object_set_new(rootJ, "routing", json_integer(routing));
@@ -168,9 +164,14 @@ struct Energy : Module {
 		if (panelThemeJ)
 			panelTheme = json_integer_value(panelThemeJ);
 
+		// paramBlockSize
+		json_t *paramBlockSizeJ = json_object_get(rootJ, "paramBlockSize");
+		if (paramBlockSizeJ)
+			controls.blockSize = ParamRamps<4>::normalizeBlockSize(json_integer_value(paramBlockSizeJ));
+
 		// oscM and oscC
-		oscM->dataFromJson(rootJ, "oscM_");
-		oscC->dataFromJson(rootJ, "oscC_");
+		oscM.dataFromJson(rootJ, "oscM_");
+		oscC.dataFromJson(rootJ, "oscC_");
 
 		// routing
 		json_t *routingJ = json_object_get(rootJ, "routing");
@@ -198,21 +199,41 @@ struct Energy : Module {
 		if (crossJ)
 			cross = json_integer_value(crossJ);
 		
+		updateKernels();
 		// resetNonJson();
 	}
 
+#ifdef GEO_PROCESS_TIMING
+	ProcessTimeHistogram processTimes{this};
+#endif
+#ifdef GEO_DENORMAL_COUNT
+	DenormalCounters denormalCounts{this, {"feedback sample"}};
+#endif
+	
 	void process(const ProcessArgs &args) override {	
+#ifdef GEO_PROCESS_TIMING
+		ProcessTimer processTimer(processTimes);
+#endif
+		DenormalGuard denormalGuard;
 		// user inputs
 		if (refresh.processInputs()) {
+			for (int i = 0; i < 2; i++) {
+				buttonTriggers.values[0 + i] = params[PLANCK_PARAMS + i].getValue();
+				buttonTriggers.values[2 + i] = params[MODTYPE_PARAMS + i].getValue();
+			}
+			buttonTriggers.values[4] = params[ROUTING_PARAM].getValue();
+			buttonTriggers.values[5] = params[CROSS_PARAM].getValue();
+			uint32_t buttonTrigs = buttonTriggers.process();
+			
 			// routing
-			if (routingTrigger.process(params[ROUTING_PARAM].getValue())) {
+			if ((buttonTrigs & (0x1 << 4)) != 0) {
 				if (++routing > 2)
 					routing = 0;
 			}
 			
 			// plancks
 			for (int i = 0; i < 2; i++) {
-				if (planckTriggers[i].process(params[PLANCK_PARAMS + i].getValue())) {
+				if ((buttonTrigs & (0x1 << (0 + i))) != 0) {
 					if (++plancks[i] > 2)
 						plancks[i] = 0;
 				}
@@ -220,39 +241,53 @@ struct Energy : Module {
 			
 			// modtypes
 			for (int i = 0; i < 2; i++) {
-				if (modtypeTriggers[i].process(params[MODTYPE_PARAMS + i].getValue())) {
+				if ((buttonTrigs & (0x1 << (2 + i))) != 0) {
 					if (++modtypes[i] > 2)
 						modtypes[i] = 0;
 				}
 			}
 			
 			// cross
-			if (crossTrigger.process(params[CROSS_PARAM].getValue())) {
+			if ((buttonTrigs & (0x1 << 5)) != 0) {
 				if (++cross > 1)
 					cross = 0;
 			}
+			
+			if ((buttonTrigs & 0x1C) != 0)// modtypes or routing changed
+				updateKernels();
 		}// userInputs refresh
 		
 		
 		// main signal flow
 		// ----------------
 		
-		float freqKnobs[2] = {calcFreqKnob(0), calcFreqKnob(1)};
-		float modSignals[2] = {calcModSignal(0, freqKnobs[0]), calcModSignal(1, freqKnobs[1])};
-		if (routing == 1)
-			modSignals[1] += modSignals[0];
-		else if (routing == 2)
-			modSignals[1] -= modSignals[0];
+		// knobs and momentum, at control rate
+		if (controls.isBlockStart()) {
+			calcFeedbacks();
+			controls.targets[0] = calcFreqKnob(0);
+			controls.targets[1] = calcFreqKnob(1);
+			controls.targets[2] = feedbacks[0];
+			controls.targets[3] = feedbacks[1];
+			controls.start();
+		}
+		controls.next();
+		
+		float freqKnobs[2] = {controls.get(0), controls.get(1)};
+		float modSignals[2];
+		(this->*modKernel)(freqKnobs, modSignals);
 		
 		// two values to send to oscs: voct and feedback (aka momentum)
 		// voct
 		float vocts[2] = {modSignals[0] + inputs[FREQCV_INPUT].getVoltage(), modSignals[1] + inputs[FREQCV_INPUT].getVoltage()};
-		// feedback (momentum)
-		calcFeedbacks();
+		// feedback (momentum), from the ramps above
 		
 		// oscillators
-		float oscMout = oscM->step(vocts[0], feedbacks[0] * 0.3f);
-		float oscCout = oscC->step(vocts[1], feedbacks[1] * 0.3f);
+		float oscMout = oscM.step(vocts[0], controls.get(2) * 0.3f);
+		float oscCout = oscC.step(vocts[1], controls.get(3) * 0.3f);
+#ifdef GEO_DENORMAL_COUNT
+		denormalCounts.check(0, oscM._feedbackDelayedSample);
+		denormalCounts.check(0, oscC._feedbackDelayedSample);
+#endif
 		
 		// final attenuverters
 		float multVal = multiplySlew.next(inputs[MULTIPLY_INPUT].isConnected() ? (clamp(inputs[MULTIPLY_INPUT].getVoltage() / 10.0f, 0.0f, 1.0f)) : 1.0f);
@@ -305,10 +340,42 @@ struct Energy : Module {
 		return (float)(retcv)/2.0f - 3.0f;
 	}
 	
+	void updateKernels() {// call when routing or modtypes[] change
+		static const ModKernel kernels[3][3][3] = {
+			{{&Energy::calcModSignals<0, 0, 0>, &Energy::calcModSignals<0, 0, 1>, &Energy::calcModSignals<0, 0, 2>},
+			 {&Energy::calcModSignals<0, 1, 0>, &Energy::calcModSignals<0, 1, 1>, &Energy::calcModSignals<0, 1, 2>},
+			 {&Energy::calcModSignals<0, 2, 0>, &Energy::calcModSignals<0, 2, 1>, &Energy::calcModSignals<0, 2, 2>}},
+			{{&Energy::calcModSignals<1, 0, 0>, &Energy::calcModSignals<1, 0, 1>, &Energy::calcModSignals<1, 0, 2>},
+			 {&Energy::calcModSignals<1, 1, 0>, &Energy::calcModSignals<1, 1, 1>, &Energy::calcModSignals<1, 1, 2>},
+			 {&Energy::calcModSignals<1, 2, 0>, &Energy::calcModSignals<1, 2, 1>, &Energy::calcModSignals<1, 2, 2>}},
+			{{&Energy::calcModSignals<2, 0, 0>, &Energy::calcModSignals<2, 0, 1>, &Energy::calcModSignals<2, 0, 2>},
+			 {&Energy::calcModSignals<2, 1, 0>, &Energy::calcModSignals<2, 1, 1>, &Energy::calcModSignals<2, 1, 2>},
+			 {&Energy::calcModSignals<2, 2, 0>, &Energy::calcModSignals<2, 2, 1>, &Energy::calcModSignals<2, 2, 2>}},
+		};
+		int routingIndex = (routing == 1 || routing == 2) ? routing : 0;
+		int modtypeIndexes[2];
+		for (int i = 0; i < 2; i++)
+			modtypeIndexes[i] = modtypes[i] == 0 ? 0 : (modtypes[i] == 1 ? 1 : 2);
+		modKernel = kernels[routingIndex][modtypeIndexes[0]][modtypeIndexes[1]];
+	}
+	
+	// Modulated freq knobs of both sides for the given routing and modtypes (instantiated for every combination and
+	//   chosen by updateKernels(), so that the modes are not tested per sample)
+	template<int ROUTING, int MODTYPE0, int MODTYPE1>
+	void calcModSignals(const float *freqKnobs, float *modSignals) {
+		modSignals[0] = calcModSignal<MODTYPE0>(0, freqKnobs[0]);
+		modSignals[1] = calcModSignal<MODTYPE1>(1, freqKnobs[1]);
+		if (ROUTING == 1)
+			modSignals[1] += modSignals[0];
+		else if (ROUTING == 2)
+			modSignals[1] -= modSignals[0];
+	}
+	
+	template<int MODTYPE>
 	inline float calcModSignal(int i, float freqValue) {
-		if (modtypes[i] == 0 || !inputs[FREQCV_INPUTS + i].isConnected())// bypass
+		if (MODTYPE == 0 || !inputs[FREQCV_INPUTS + i].isConnected())// bypass
 			return freqValue;
-		if (modtypes[i] == 1) // add
+		if (MODTYPE == 1) // add
 			return freqValue + inputs[FREQCV_INPUTS + i].getVoltage();
 		// amp
 		return freqValue * (clamp(inputs[FREQCV_INPUTS + i].getVoltage(), 0.0f, 10.0f) / 10.0f);
@@ -341,6 +408,17 @@ struct Energy : Module {
 
 
 struct EnergyWidget : ModuleWidget {
+	void appendContextMenu(Menu *menu) override {
+		Energy *module = dynamic_cast<Energy*>(this->module);
+		assert(module);
+		
+		appendParamBlockSizeMenu(menu, &module->controls.blockSize);
+		
+#ifdef GEO_PROCESS_TIMING
+		appendProcessTimesMenu(menu, module);
+#endif
+	}
+	
 	EnergyWidget(Energy *module) {
 		setModule(module);
 
@@ -43,13 +43,6 @@ float SlewLimiter::next(float sample, float last) {
 // Amplifier
 //-----------------------------------------------------------------------------
 
-void Table::generate() {
-	if (!_table) {
-		_table = new float[_length] {};
-		_generate();
-	}
-}
-
 void SineTable::_generate() {
 	const float twoPI = 2.0f * M_PI;
 	for (int i = 0, j = _length / 4; i <= j; ++i) {
@@ -68,36 +61,23 @@ void SineTable::_generate() {
 // Decimator
 //-----------------------------------------------------------------------------
 
-CICDecimator::CICDecimator(int stages, int factor) {
-	assert(stages > 0);
-	_stages = stages;
-	_integrators = new T[_stages + 1] {};
-	_combs = new T[_stages] {};
-	setParams(0.0f, factor);
-}
-
-CICDecimator::~CICDecimator() {
-	delete[] _integrators;
-	delete[] _combs;
-}
-
-void CICDecimator::setParams(float _sampleRate, int factor) {
+template<int STAGES> void CICDecimator<STAGES>::setParams(float _sampleRate, int factor) {
 	assert(factor > 0);
 	if (_factor != factor) {
 		_factor = factor;
-		_gainCorrection = 1.0f / (float)(pow(_factor, _stages));
+		_gainCorrection = 1.0f / (float)(pow(_factor, STAGES));
 	}
 }
 
-float CICDecimator::next(const float* buf) {
+template<int STAGES> float CICDecimator<STAGES>::next(const float* buf) {
 	for (int i = 0; i < _factor; ++i) {
 		_integrators[0] = buf[i] * scale;
-		for (int j = 1; j <= _stages; ++j) {
+		for (int j = 1; j <= STAGES; ++j) {
 			_integrators[j] += _integrators[j - 1];
 		}
 	}
-	T s = _integrators[_stages];
-	for (int i = 0; i < _stages; ++i) {
+	T s = _integrators[STAGES];
+	for (int i = 0; i < STAGES; ++i) {
 		T t = s;
 		s -= _combs[i];
 		_combs[i] = t;
@@ -105,6 +85,8 @@ float CICDecimator::next(const float* buf) {
 	return _gainCorrection * (s / (float)scale);
 }
 
+template struct CICDecimator<4>;// the one of FMOp
+
 
 //-----------------------------------------------------------------------------
 // SineTableOscillator
@@ -187,7 +169,7 @@ float TablePhasor::_nextForPhase(phase_t phase) {
 const float referenceFrequency = 261.626; // C4; frequency at which Rack 1v/octave CVs are zero.
 
 inline float cvToFrequency(float cv) {
-	return std::pow(2.0f, cv) * referenceFrequency;
+	return fastExp2(cv) * referenceFrequency;
 }
 
 void FMOp::onReset() {
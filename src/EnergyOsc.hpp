@@ -48,26 +48,24 @@ protected:
 	float* _table = NULL;
 
 public:
-	Table(int n = 10) {
+	Table(int n, float* table) {
 		assert(n > 0);
 		assert(n <= 16);
 		_length = 1 << n;
+		_table = table;
 	}
-	virtual ~Table() {
-		if (_table) {
-			delete[] _table;
-		}
-	}
+	virtual ~Table() {}
 
 	inline int length() const { return _length; }
 
 	inline float value(int i) const {
 		assert(i >= 0 && i < _length);
-		assert(_table);
 		return _table[i];
 	}
 
-	void generate();
+	void generate() {
+		_generate();
+	}
 
 protected:
 	virtual void _generate() = 0;
@@ -76,32 +74,26 @@ protected:
 
 template<class T, int N> class StaticTable {
 private:
-	Table* _table = NULL;
-
-	StaticTable() {
-	}
-	~StaticTable() {
-		if (_table) {
-			delete _table;
-		}
-	}
+	alignas(16) static float _storage[1 << N];
+	static T _instance;
 
 public:
-	StaticTable(const StaticTable&) = delete;
-	void operator=(const StaticTable&) = delete;
+	// Called once by init() in Geodesics.cpp, before any module is constructed; the table is then only read, from
+	// any thread, with no first use check
+	static void generate() {
+		_instance.generate();
+	}
 
 	static const Table& table() {
-		static StaticTable<T, N> instance;
-		if (!instance._table) {
-			instance._table = new T(N);
-			instance._table->generate();
-		}
-		return *instance._table;
+		return _instance;
 	}
 };
 
+template<class T, int N> float StaticTable<T, N>::_storage[1 << N];
+template<class T, int N> T StaticTable<T, N>::_instance(N, _storage);
+
 struct SineTable : Table {
-	SineTable(int n = 10) : Table(n) {}
+	SineTable(int n, float* table) : Table(n, table) {}
 	void _generate() override;
 };
 struct StaticSineTable : StaticTable<SineTable, 12> {};
@@ -119,17 +111,18 @@ struct Decimator {
 	virtual float next(const float* buf) = 0;
 };
 
-struct CICDecimator : Decimator {
+template<int STAGES> struct CICDecimator : Decimator {
+	static_assert(STAGES > 0, "CICDecimator needs at least one stage");
 	typedef int64_t T;
 	static constexpr T scale = ((T)1) << 32;
-	int _stages;
-	T* _integrators;
-	T* _combs;
+	T _integrators[STAGES + 1] = {};
+	T _combs[STAGES] = {};
 	int _factor = 0;
 	float _gainCorrection;
 
-	CICDecimator(int stages = 4, int factor = 8);
-	virtual ~CICDecimator();
+	CICDecimator(int factor = 8) {
+		setParams(0.0f, factor);
+	}
 
 	void setParams(float sampleRate, int factor) override;
 	float next(const float* buf) override;
@@ -283,21 +276,21 @@ struct SineTableOscillator : TablePhasor {
 //-----------------------------------------------------------------------------
 
 struct FMOp {
-	const float amplitude = 5.0f;
-	const int modulationSteps = 100;
+	static constexpr float amplitude = 5.0f;
+	static constexpr int modulationSteps = 100;
 	static constexpr int oversample = 8;
-	const float oversampleMixIncrement = 0.01f;
+	static constexpr float oversampleMixIncrement = 0.01f;
 	int _steps = 0;
 	float _feedbackDelayedSample = 0.0f;
 	float _maxFrequency = 0.0f;
-	float _buffer[oversample];
+	alignas(16) float _buffer[oversample];
 	float _oversampleMix = 0.0f;
 	Phasor _phasor;
 	SineTableOscillator _sineTable;
-	CICDecimator _decimator;
+	CICDecimator<4> _decimator;
 	SlewLimiter _feedbackSL;
 
-	FMOp(float _sampleRate)
+	FMOp(float _sampleRate = 44100.0f)// default for inline members, whose owner then sets the engine's rate
 	{
 		onReset();
 		onSampleRateChange(_sampleRate);
@@ -79,9 +79,11 @@ struct Entropia : Module {
 	
 	// Need to save, no reset
 	int panelTheme;
+	GeoRandom rng;
 	
 	// Need to save, with reset
 	bool running;
+	JumpWeights jumpWeights;// distribution of the uncertainty jumps
 	bool resetOnRun;
 	int length;
 	int quantize;// a.k.a. plank constant, bit0 = blue, bit1 = yellow
@@ -105,32 +107,21 @@ struct Entropia : Module {
 	float cvLight = 0.0f;
 	float stepClockLight = 0.0f;
 	float stateSwitchLight = 0.0f;
-	RefreshCounter refresh;
+	RefreshCounter refresh{49.0f, 104.0f};
 	Trigger runningTrigger;
-	Trigger plankTriggers[2];
-	Trigger lengthTrigger;
-	Trigger stateSwitchTrigger;
-	Trigger switchAddTrigger;
-	Trigger certainClockTrigger;
-	Trigger uncertainClockTrigger;
-	Trigger octTriggers[2];
+	TriggerBank<17> buttonTriggers;// plank 0-1, oct 2-3, random 4-5, extsig 6-7, fixedcv 8-9, extaudio 10-11, length 12, switchadd 13, stateswitch 14, reset on run 15, clksrc 16
+	TriggerBank<2> clockTriggers;// certain 0, uncertain 1
 	Trigger stepClockTrigger;
 	Trigger resetTrigger;
-	Trigger resetOnRunTrigger;
-	Trigger fixedSrcTriggers[2];
-	Trigger rndSrcTriggers[2];
-	Trigger extSrcTriggers[2];
-	Trigger extAudioTriggers[2];
-	Trigger clkSrcTrigger;
 	
 	inline float quantizeCV(float cv) {return std::round(cv * 12.0f) / 12.0f;}
 	inline void updatePipeBlue(int step) {
 		float effectiveKnob = params[PROB_PARAMS + step].getValue() + -1.0f * (params[GPROB_PARAM].getValue() + inputs[GPROB_INPUT].getVoltage() / 5.0f);
-		pipeBlue[step] = effectiveKnob > random::uniform();
+		pipeBlue[step] = effectiveKnob > rng.uniform();
 	}
 	inline void updateRandomCVs() {
-		randomCVs[0] = random::uniform();
-		randomCVs[1] = random::uniform();
+		randomCVs[0] = rng.uniform();
+		randomCVs[1] = rng.uniform();
 		cvLight = 1.0f;// this could be elsewhere since no relevance to randomCVs, but ok here
 	}
 	
@@ -177,6 +168,7 @@ struct Entropia : Module {
 		configParam(STEPCLOCK_PARAM, 0.0f, 1.0f, 0.0f, "Magnetic clock");			
 		configParam(RESETONRUN_PARAM, 0.0f, 1.0f, 0.0f, "Reset on run");				
 						
+		rng.seed(random::u64());
 		onReset();
 
 		panelTheme = (loadDarkAsDefault() ? 1 : 0);
@@ -185,6 +177,7 @@ struct Entropia : Module {
 	
 	void onReset() override {
 		running = true;
+		jumpWeights.reset();
 		resetOnRun = false;
 		length = 8;
 		quantize = 3;
@@ -229,6 +222,9 @@ struct Entropia : Module {
 		// panelTheme
 		json_object_set_new(rootJ, "panelTheme", json_integer(panelTheme));
 
+		// randomSeed
+		json_object_set_new(rootJ, "randomSeed", rng.seedToJson());
+
 		// running
 		json_object_set_new(rootJ, "running", json_boolean(running));
 
@@ -268,6 +264,9 @@ struct Entropia : Module {
 		// clkSource
 		json_object_set_new(rootJ, "clkSource", json_integer(clkSource));
 
+		// jumpWeights
+		json_object_set_new(rootJ, "jumpWeights", jumpWeights.toJson());
+
 		return rootJ;
 	}
 
@@ -278,6 +277,9 @@ struct Entropia : Module {
 		if (panelThemeJ)
 			panelTheme = json_integer_value(panelThemeJ);
 
+		// randomSeed
+		rng.seedFromJson(json_object_get(rootJ, "randomSeed"));
+
 		// running
 		json_t *runningJ = json_object_get(rootJ, "running");
 		if (runningJ)
@@ -347,11 +349,22 @@ struct Entropia : Module {
 		if (clkSourceJ)
 			clkSource = json_integer_value(clkSourceJ);
 
+		// jumpWeights
+		jumpWeights.fromJson(json_object_get(rootJ, "jumpWeights"));
+
 		resetNonJson(false);// soft init, don't want to init stepIndex, pipeBlue nor randomCVs
 	}
 
 	
+#ifdef GEO_PROCESS_TIMING
+	ProcessTimeHistogram processTimes{this};
+#endif
+	
 	void process(const ProcessArgs &args) override {
+#ifdef GEO_PROCESS_TIMING
+		ProcessTimer processTimer(processTimes);
+#endif
+		DenormalGuard denormalGuard;
 		float crossFadeTime = 0.005f;
 	
 		//********** Buttons, knobs, switches and inputs **********
@@ -367,8 +380,23 @@ struct Entropia : Module {
 		}
 		
 		if (refresh.processInputs()) {
+			for (int i = 0; i < 2; i++) {
+				buttonTriggers.values[0 + i] = params[QUANTIZE_PARAMS + i].getValue();
+				buttonTriggers.values[2 + i] = params[OCT_PARAMS + i].getValue();
+				buttonTriggers.values[4 + i] = params[RANDOM_PARAMS + i].getValue();
+				buttonTriggers.values[6 + i] = params[EXTSIG_PARAMS + i].getValue();
+				buttonTriggers.values[8 + i] = params[FIXEDCV_PARAMS + i].getValue();
+				buttonTriggers.values[10 + i] = params[EXTAUDIO_PARAMS + i].getValue();
+			}
+			buttonTriggers.values[12] = params[LENGTH_PARAM].getValue();
+			buttonTriggers.values[13] = params[SWITCHADD_PARAM].getValue() + inputs[SWITCHADD_INPUT].getVoltage();
+			buttonTriggers.values[14] = params[STATESWITCH_PARAM].getValue() + inputs[STATESWITCH_INPUT].getVoltage();
+			buttonTriggers.values[15] = params[RESETONRUN_PARAM].getValue();
+			buttonTriggers.values[16] = params[CLKSRC_PARAM].getValue();
+			uint32_t buttonTrigs = buttonTriggers.process();
+			
 			// Length button and input
-			bool lengthTrig = lengthTrigger.process(params[LENGTH_PARAM].getValue());
+			bool lengthTrig = (buttonTrigs & (0x1 << 12)) != 0;
 			if (inputs[LENGTH_INPUT].isConnected()) {
 				length = clamp(8 - (int)(inputs[LENGTH_INPUT].getVoltage() * 7.0f / 10.0f + 0.5f)  , 1, 8);
 			}
@@ -378,14 +406,14 @@ struct Entropia : Module {
 			}
 
 			// Plank buttons (quantize)
-			if (plankTriggers[0].process(params[QUANTIZE_PARAMS + 0].getValue()))
+			if ((buttonTrigs & (0x1 << 0)) != 0)
 				quantize ^= 0x1;
-			if (plankTriggers[1].process(params[QUANTIZE_PARAMS + 1].getValue()))
+			if ((buttonTrigs & (0x1 << 1)) != 0)
 				quantize ^= 0x2;
 
 			// Range buttons and CV inputs
 			for (int i = 0; i < 2; i++) {
-				bool rangeTrig = octTriggers[i].process(params[OCT_PARAMS + i].getValue());
+				bool rangeTrig = (buttonTrigs & (0x1 << (2 + i))) != 0;
 				if (inputs[OCTCV_INPUTS + i].isConnected()) {
 					if (inputs[OCTCV_INPUTS + i].getVoltage() <= -1.0f)
 						ranges[i] = 0;
@@ -414,33 +442,33 @@ struct Entropia : Module {
 			
 			// Source buttons (fixedCV, random, ext)
 			for (int i = 0; i < 2; i++) {
-				if (rndSrcTriggers[i].process(params[RANDOM_PARAMS + i].getValue()))
+				if ((buttonTrigs & (0x1 << (4 + i))) != 0)
 					sources[i] = SRC_RND;
-				if (extSrcTriggers[i].process(params[EXTSIG_PARAMS + i].getValue()))
+				if ((buttonTrigs & (0x1 << (6 + i))) != 0)
 					sources[i] = SRC_EXT;
-				if (fixedSrcTriggers[i].process(params[FIXEDCV_PARAMS + i].getValue()))
+				if ((buttonTrigs & (0x1 << (8 + i))) != 0)
 					sources[i] = SRC_CV;
-				if (extAudioTriggers[i].process(params[EXTAUDIO_PARAMS + i].getValue()))
+				if ((buttonTrigs & (0x1 << (10 + i))) != 0)
 					audio ^= (1 << i);
 			}
 			
 			// addMode
-			if (switchAddTrigger.process(params[SWITCHADD_PARAM].getValue() + inputs[SWITCHADD_INPUT].getVoltage())) {
+			if ((buttonTrigs & (0x1 << 13)) != 0) {
 				addMode = !addMode;
 			}		
 		
 			// StateSwitch
-			if (stateSwitchTrigger.process(params[STATESWITCH_PARAM].getValue() + inputs[STATESWITCH_INPUT].getVoltage())) {
+			if ((buttonTrigs & (0x1 << 14)) != 0) {
 				pipeBlue[stepIndex] = !pipeBlue[stepIndex];
 				stateSwitchLight = 1.0f;
 			}		
 		
 			// Reset on Run button
-			if (resetOnRunTrigger.process(params[RESETONRUN_PARAM].getValue())) {
+			if ((buttonTrigs & (0x1 << 15)) != 0) {
 				resetOnRun = !resetOnRun;
 			}	
 
-			if (clkSrcTrigger.process(params[CLKSRC_PARAM].getValue())) {
+			if ((buttonTrigs & (0x1 << 16)) != 0) {
 				if (++clkSource > 2)
 					clkSource = 0;
 			}
@@ -451,15 +479,18 @@ struct Entropia : Module {
 		
 		// External clocks
 		if (running && clockIgnoreOnReset == 0l) {
-			bool certainClockTrig = certainClockTrigger.process(inputs[CERTAIN_CLK_INPUT].getVoltage());
-			bool uncertainClockTrig = uncertainClockTrigger.process(inputs[UNCERTAIN_CLK_INPUT].getVoltage());
+			clockTriggers.values[0] = inputs[CERTAIN_CLK_INPUT].getVoltage();
+			clockTriggers.values[1] = inputs[UNCERTAIN_CLK_INPUT].getVoltage();
+			uint32_t clockTrigs = clockTriggers.process();
+			bool certainClockTrig = (clockTrigs & 0x1) != 0;
+			bool uncertainClockTrig = (clockTrigs & 0x2) != 0;
 			certainClockTrig &= (clkSource < 2);
 			if (certainClockTrig) {
 				stepIndex++;
 			}
 			uncertainClockTrig &= ((clkSource & 0x1) == 0);
 			if (uncertainClockTrig) {
-				stepIndex += getWeighted1to8random();
+				stepIndex += jumpWeights.sample(rng);
 			}
 			if (certainClockTrig || uncertainClockTrig) {
 				stepIndex %= length;
@@ -481,8 +512,7 @@ struct Entropia : Module {
 		if (resetTrigger.process(inputs[RESET_INPUT].getVoltage() + params[RESET_PARAM].getValue())) {
 			initRun(true);
 			resetLight = 1.0f;
-			certainClockTrigger.reset();
-			uncertainClockTrigger.reset();
+			clockTriggers.reset();
 		}
 		
 		
@@ -612,6 +642,17 @@ struct Entropia : Module {
 
 
 struct EntropiaWidget : ModuleWidget {
+	void appendContextMenu(Menu *menu) override {
+		Entropia *module = dynamic_cast<Entropia*>(this->module);
+		assert(module);
+		
+		appendJumpWeightsMenu(menu, &module->jumpWeights);
+		
+#ifdef GEO_PROCESS_TIMING
+		appendProcessTimesMenu(menu, module);
+#endif
+	}
+	
 	EntropiaWidget(Entropia *module) {
 		setModule(module);
 
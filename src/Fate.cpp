@@ -41,16 +41,17 @@ struct Fate : Module {
 	
 	// Need to save
 	int panelTheme;
+	GeoRandom rng;
 	
 	// No need to save
-	RefreshCounter refresh;
+	RefreshCounter refresh{0.0f, 34.0f};
 	Trigger clockTrigger;
 	float addCV;
 	bool sourceExMachina;
 	float trigLights[2] = {1.0f, 1.0f};// white, blue
 
 
-	inline bool isAlteredFate() {return (random::uniform() < (params[FREEWILL_PARAM].getValue() + inputs[FREEWILL_INPUT].getVoltage() / 10.0f));}// randomUniform is [0.0, 1.0)
+	inline bool isAlteredFate() {return (rng.uniform() < (params[FREEWILL_PARAM].getValue() + inputs[FREEWILL_INPUT].getVoltage() / 10.0f));}// randomUniform is [0.0, 1.0)
 
 	
 	Fate() {
@@ -59,6 +60,7 @@ struct Fate : Module {
 		configParam(Fate::FREEWILL_PARAM, 0.0f, 1.0f, 0.0f, "Free will");
 		configParam(Fate::CHOICESDEPTH_PARAM, 0.0f, 1.0f, 0.5f, "Choices depth");
 
+		rng.seed(random::u64());
 		onReset();
 
 		panelTheme = (loadDarkAsDefault() ? 1 : 0);
@@ -81,6 +83,9 @@ struct Fate : Module {
 		// panelTheme
 		json_object_set_new(rootJ, "panelTheme", json_integer(panelTheme));
 
+		// randomSeed
+		json_object_set_new(rootJ, "randomSeed", rng.seedToJson());
+
 		return rootJ;
 	}
 
@@ -91,12 +96,23 @@ struct Fate : Module {
 		json_t *panelThemeJ = json_object_get(rootJ, "panelTheme");
 		if (panelThemeJ)
 			panelTheme = json_integer_value(panelThemeJ);
+
+		// randomSeed
+		rng.seedFromJson(json_object_get(rootJ, "randomSeed"));
 		
 		addCV = 0.0f;
 		sourceExMachina = false;
 	}
 
+#ifdef GEO_PROCESS_TIMING
+	ProcessTimeHistogram processTimes{this};
+#endif
+	
 	void process(const ProcessArgs &args) override {		
+#ifdef GEO_PROCESS_TIMING
+		ProcessTimer processTimer(processTimes);
+#endif
+		DenormalGuard denormalGuard;
 		// user inputs
 		//if (refresh.processInputs()) {
 			// none
@@ -110,7 +126,7 @@ struct Fate : Module {
 				if (inputs[CHOICSDEPTH_INPUT].isConnected()) {
 					choicesDepthCVinput = inputs[CHOICSDEPTH_INPUT].getVoltage() / 10.0f;
 				}
-				addCV = (random::uniform() * 10.0f - 5.0f);
+				addCV = (rng.uniform() * 10.0f - 5.0f);
 				addCV *= clamp(params[CHOICESDEPTH_PARAM].getValue() + choicesDepthCVinput, 0.0f, 1.0f);
 				trigLights[1] = 1.0f;
 				sourceExMachina = inputs[EXMACHINA_INPUT].isConnected();
@@ -140,6 +156,12 @@ struct Fate : Module {
 
 
 struct FateWidget : ModuleWidget {
+#ifdef GEO_PROCESS_TIMING
+	void appendContextMenu(Menu *menu) override {
+		appendProcessTimesMenu(menu, module);
+	}
+	
+#endif
 	FateWidget(Fate *module) {
 		setModule(module);
 
@@ -0,0 +1,127 @@
+//***********************************************************************************************
+//Geodesics: A modular collection for VCV Rack by Pierre Collard and Marc Boulé
+//
+//Fast exp2, exp and pow for the hot paths, scalar and in SIMD lanes
+//  The polynomial is the one of Cephes' expf (also in sse_mathfun), on a reduced range
+//See ./LICENSE.txt for all licenses
+//***********************************************************************************************
+
+
+#ifndef GEO_MATH_HPP
+#define GEO_MATH_HPP
+
+#include <cmath>
+#include <cstring>
+#include "rack.hpp"
+
+using namespace rack;
+
+
+// exp2(x) = 2^n * e^(f * ln2) with n = round(x) and f = x - n in [-0.5, 0.5], where e^z is the degree 7 Cephes
+//   polynomial. x is clamped to [-126, 126], so that 2^n is always a normal float. The scalar and the SIMD versions
+//   have the same arithmetic and give the same results lane by lane. The maximum relative errors below are checked
+//   against the standard library over their domains with geodesics-bench -m
+
+static const float fastExp2MaxError = 2e-7f;// relative, any x
+static const float fastExpMaxError = 1e-6f;// relative, for |x| <= 10 (error of x * log2(e) grows with |x|)
+static const float fastPowMaxError = 1e-6f;// relative, for |x * log2(base)| <= 14
+
+namespace geomath {
+	static constexpr float ln2 = 0.693147180559945309f;
+	static constexpr float log2e = 1.44269504088896341f;
+	
+	inline float polyExp(float z) {// e^z for |z| <= ln2 / 2
+		float p = 1.9875691500e-4f;
+		p = p * z + 1.3981999507e-3f;
+		p = p * z + 8.3334519073e-3f;
+		p = p * z + 4.1665795894e-2f;
+		p = p * z + 1.6666665459e-1f;
+		p = p * z + 5.0000001201e-1f;
+		return p * z * z + z + 1.0f;
+	}
+	inline simd::float_4 polyExp(simd::float_4 z) {
+		simd::float_4 p = 1.9875691500e-4f;
+		p = p * z + 1.3981999507e-3f;
+		p = p * z + 8.3334519073e-3f;
+		p = p * z + 4.1665795894e-2f;
+		p = p * z + 1.6666665459e-1f;
+		p = p * z + 5.0000001201e-1f;
+		return p * z * z + z + 1.0f;
+	}
+}// namespace geomath
+
+
+#ifdef GEO_REFERENCE_MATH
+
+// Reference build of the bench (see bench/Golden.cpp): the same functions through the standard library, lane by lane
+
+inline float fastExp2(float x) {
+	return std::exp2(std::min(std::max(x, -126.0f), 126.0f));
+}
+
+inline simd::float_4 fastExp2(simd::float_4 x) {
+	return simd::float_4(fastExp2(x[0]), fastExp2(x[1]), fastExp2(x[2]), fastExp2(x[3]));
+}
+
+inline float fastExp(float x) {
+	return std::exp(x);
+}
+
+inline simd::float_4 fastExp(simd::float_4 x) {
+	return simd::float_4(std::exp(x[0]), std::exp(x[1]), std::exp(x[2]), std::exp(x[3]));
+}
+
+inline float fastPow(float base, float x) {
+	return std::pow(base, x);
+}
+
+inline simd::float_4 fastPow(float base, simd::float_4 x) {
+	return simd::float_4(std::pow(base, x[0]), std::pow(base, x[1]), std::pow(base, x[2]), std::pow(base, x[3]));
+}
+
+#else
+
+inline float fastExp2(float x) {
+	x = std::min(std::max(x, -126.0f), 126.0f);// maxss and minss, as in the SIMD version (std::fmax is a libm call)
+	float t = x + 0.5f;
+	int n = (int)t;// truncation, then floor below (no SSE4.1 rounding with -march=nocona)
+	n -= ((float)n > t) ? 1 : 0;
+	float p = geomath::polyExp((x - (float)n) * geomath::ln2);
+	int32_t bits = (n + 127) << 23;
+	float scale;
+	std::memcpy(&scale, &bits, sizeof(scale));
+	return p * scale;
+}
+
+inline simd::float_4 fastExp2(simd::float_4 x) {
+	x = simd::clamp(x, -126.0f, 126.0f);
+	simd::float_4 t = x + 0.5f;
+	simd::float_4 n = simd::float_4(simd::int32_4(t));
+	n -= simd::float_4(1.0f) & (n > t);
+	simd::float_4 p = geomath::polyExp((x - n) * geomath::ln2);
+	simd::int32_4 bits = (simd::int32_4(n) + 127) << 23;
+	return p * simd::float_4::cast(bits);
+}
+
+
+inline float fastExp(float x) {
+	return fastExp2(x * geomath::log2e);
+}
+
+inline simd::float_4 fastExp(simd::float_4 x) {
+	return fastExp2(x * geomath::log2e);
+}
+
+
+// base must be > 0; with a constant base, std::log2(base) is folded at compile time
+inline float fastPow(float base, float x) {
+	return fastExp2(x * std::log2(base));
+}
+
+inline simd::float_4 fastPow(float base, simd::float_4 x) {
+	return fastExp2(x * std::log2(base));
+}
+
+#endif
+
+#endif
@@ -9,7 +9,10 @@
 //***********************************************************************************************
 
 
+#include <mutex>
+#include <set>
 #include "Geodesics.hpp"
+#include "EnergyOsc.hpp"
 
 
 Plugin *pluginInstance;
@@ -17,6 +20,10 @@ Plugin *pluginInstance;
 
 void init(rack::Plugin *p) {
 	pluginInstance = p;
+	
+	// Shared DSP tables, built here once so that no module has to check for them (or race to build them) when
+	// constructed or processed on an engine thread
+	StaticSineTable::generate();
 
 	p->addModel(modelBlackHoles);
 	p->addModel(modelPulsars);
@@ -36,6 +43,155 @@ void init(rack::Plugin *p) {
 // other
 
 
+// Control-rate scheduler shared by all RefreshCounters of the plugin. Instances are registered when constructed
+//   (UI thread); the first one is the leader that publishes its frame count, until it is removed or stops being
+//   processed (see RefreshCounter::processLights()).
+//   A new instance takes the slot that gives the lowest peak load over the samples where its work lands:
+//   its input work on the 16 samples of its phase in the input cycle, its light work on its slot alone.
+struct RefreshScheduler {
+	std::mutex mutex;
+	std::vector<RefreshCounter*> counters;// in registration order
+	float inputLoads[RefreshCounter::userInputsStepSkipMask + 1] = {};
+	float lightLoads[RefreshCounter::displayRefreshStepSkips] = {};
+	
+	unsigned int add(RefreshCounter *counter) {
+		static const unsigned int numPhases = RefreshCounter::userInputsStepSkipMask + 1;
+		std::lock_guard<std::mutex> lock(mutex);
+		unsigned int bestSlot = 0;
+		float bestPeak = 0.0f;
+		for (unsigned int phase = 0; phase < numPhases; phase++) {
+			// light slots whose input work lands on this phase: slot + 1 is a multiple of 16 (inputs run the sample after lights)
+			unsigned int first = (numPhases - 1 + numPhases - phase) % numPhases;
+			unsigned int minSlot = first;
+			float maxLight = 0.0f;
+			for (unsigned int s = first; s < RefreshCounter::displayRefreshStepSkips; s += numPhases) {
+				if (lightLoads[s] < lightLoads[minSlot])
+					minSlot = s;
+				maxLight = std::max(maxLight, lightLoads[s]);
+			}
+			float peak = inputLoads[phase] + counter->inputCost + std::max(maxLight, lightLoads[minSlot] + counter->lightCost);
+			if (phase == 0 || peak < bestPeak) {
+				bestPeak = peak;
+				bestSlot = minSlot;
+			}
+		}
+		inputLoads[inputPhase(bestSlot)] += counter->inputCost;
+		lightLoads[bestSlot] += counter->lightCost;
+		counters.push_back(counter);
+		if (counters.size() == 1)
+			RefreshCounter::frameCount = 0;
+		if (!RefreshCounter::leader.load())
+			RefreshCounter::leader = counter;
+		return bestSlot;
+	}
+	
+	void remove(RefreshCounter *counter) {
+		std::lock_guard<std::mutex> lock(mutex);
+		inputLoads[inputPhase(counter->slot)] -= counter->inputCost;
+		lightLoads[counter->slot] -= counter->lightCost;
+		counters.erase(std::find(counters.begin(), counters.end(), counter));
+		RefreshCounter *removed = counter;// unless another instance took the lead meanwhile
+		RefreshCounter::leader.compare_exchange_strong(removed, counters.empty() ? NULL : counters.front());
+		if (counters.empty()) {// no residue from rounding
+			for (float &load : inputLoads)
+				load = 0.0f;
+			for (float &load : lightLoads)
+				load = 0.0f;
+		}
+	}
+	
+	static unsigned int inputPhase(unsigned int slot) {
+		// processInputs() is true when the counter is a multiple of 16, the counter is slot + frame (mod 256)
+		return (RefreshCounter::userInputsStepSkipMask + 1 - (slot & RefreshCounter::userInputsStepSkipMask)) & RefreshCounter::userInputsStepSkipMask;
+	}
+};
+
+static RefreshScheduler refreshScheduler;
+
+std::atomic<unsigned int> RefreshCounter::frameCount{0};
+std::atomic<RefreshCounter*> RefreshCounter::leader{NULL};
+
+
+RefreshCounter::RefreshCounter(float _inputCost, float _lightCost) {
+	inputCost = _inputCost;
+	lightCost = _lightCost;
+	slot = refreshScheduler.add(this);
+	refreshCounter = slot;
+}
+
+RefreshCounter::~RefreshCounter() {
+	refreshScheduler.remove(this);
+}
+
+void RefreshCounter::takeLead(RefreshCounter *currentLeader) {
+	// The compare-exchange lets a single one of the instances that noticed the stalled leader take over, even when
+	//   they run on different threads; the others see the new leader's count from the next frame on
+	if (leader.compare_exchange_strong(currentLeader, this, std::memory_order_relaxed))
+		frameCount.store(frame, std::memory_order_relaxed);
+}
+
+
+// Seeds of the live generators, for seedFromJson(). One set for the whole plugin, since a generator can be created on
+//   one thread and reseeded or deleted on another; the lock is only taken by construction, seeding and deletion,
+//   which are not on the audio thread
+static std::mutex liveSeedsMutex;
+static std::multiset<uint64_t> liveSeeds;
+
+static void replaceLiveSeed(uint64_t oldSeed, uint64_t newSeed) {
+	std::lock_guard<std::mutex> lock(liveSeedsMutex);
+	std::multiset<uint64_t>::iterator it = liveSeeds.find(oldSeed);
+	if (it != liveSeeds.end())
+		liveSeeds.erase(it);
+	liveSeeds.insert(newSeed);
+}
+
+static bool isLiveSeed(uint64_t seed) {
+	std::lock_guard<std::mutex> lock(liveSeedsMutex);
+	return liveSeeds.count(seed) > 0;
+}
+
+GeoRandom::GeoRandom() {
+	seedValue = 0;
+	{
+		std::lock_guard<std::mutex> lock(liveSeedsMutex);
+		liveSeeds.insert(seedValue);
+	}
+	seed(0);
+}
+
+GeoRandom::~GeoRandom() {
+	std::lock_guard<std::mutex> lock(liveSeedsMutex);
+	std::multiset<uint64_t>::iterator it = liveSeeds.find(seedValue);
+	if (it != liveSeeds.end())
+		liveSeeds.erase(it);
+}
+
+void GeoRandom::seed(uint64_t _seedValue) {
+	replaceLiveSeed(seedValue, _seedValue);
+	// splitmix64 expansion of the seed into the 16 words of state, so that any seed (including 0) gives a well mixed state
+	seedValue = _seedValue;
+	uint64_t x = _seedValue;
+	for (int i = 0; i < 8; i++) {
+		uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		z ^= (z >> 31);
+		s[i >> 1][(i & 0x1) * 2 + 0] = (int32_t)(uint32_t)z;
+		s[i >> 1][(i & 0x1) * 2 + 1] = (int32_t)(uint32_t)(z >> 32);
+	}
+	cacheIndex = 4;
+}
+
+void GeoRandom::seedFromJson(json_t *seedJ) {
+	if (!seedJ || !json_string_value(seedJ))
+		return;
+	uint64_t savedSeed = std::strtoull(json_string_value(seedJ), NULL, 10);
+	if (savedSeed != seedValue && isLiveSeed(savedSeed))
+		savedSeed = random::u64();// duplicated module
+	seed(savedSeed);
+}
+
+
 bool Trigger::process(float in) {
 	switch (state) {
 		case LOW:
@@ -92,25 +248,257 @@ bool HoldDetect::process(float paramValue) {
 }
 
 
-int getWeighted1to8random() {
-	int	prob = random::u32() % 1000;
-	if (prob < 175)
-		return 1;
-	else if (prob < 330) // 175 + 155
-		return 2;
-	else if (prob < 475) // 175 + 155 + 145
-		return 3;
-	else if (prob < 610) // 175 + 155 + 145 + 135
-		return 4;
-	else if (prob < 725) // 175 + 155 + 145 + 135 + 115
-		return 5;
-	else if (prob < 830) // 175 + 155 + 145 + 135 + 115 + 105
-		return 6;
-	else if (prob < 925) // 175 + 155 + 145 + 135 + 115 + 105 + 95
-		return 7;
-	return 8;
+constexpr float JumpWeights::defaultWeights[];
+
+float JumpWeights::getProbability(int i) {
+	float sum = 0.0f;
+	for (int j = 0; j < NUM_JUMPS; j++)
+		sum += weights[j];
+	return sum > 0.0f ? weights[i] / sum : 1.0f / NUM_JUMPS;
+}
+
+json_t *JumpWeights::toJson() {
+	json_t *weightsJ = json_array();
+	for (int i = 0; i < NUM_JUMPS; i++)
+		json_array_append_new(weightsJ, json_real(weights[i]));
+	return weightsJ;
+}
+
+void JumpWeights::fromJson(json_t *weightsJ) {
+	if (weightsJ) {
+		for (int i = 0; i < NUM_JUMPS; i++) {
+			json_t *weightJ = json_array_get(weightsJ, i);
+			if (weightJ)
+				weights[i] = clamp((float)json_number_value(weightJ), 0.0f, 1000.0f);
+		}
+		table.build(weights);
+	}
+}
+
+
+struct JumpWeightQuantity : Quantity {
+	JumpWeights *jumpWeights;
+	int jump;
+	
+	void setValue(float value) override {
+		jumpWeights->setWeight(jump, clamp(value, getMinValue(), getMaxValue()));
+	}
+	float getValue() override {
+		return jumpWeights->weights[jump];
+	}
+	float getMinValue() override {return 0.0f;}
+	float getMaxValue() override {return 1000.0f;}
+	float getDefaultValue() override {return JumpWeights::defaultWeights[jump];}
+	std::string getLabel() override {
+		return string::f("Jump of %i", jump + 1);
+	}
+	std::string getDisplayValueString() override {// the resulting probability rather than the raw weight
+		return string::f("%.1f%%", jumpWeights->getProbability(jump) * 100.0f);
+	}
+};
+
+struct JumpWeightSlider : Slider {
+	JumpWeightSlider(JumpWeights *jumpWeights, int jump) {
+		JumpWeightQuantity *jumpQuantity = new JumpWeightQuantity();
+		jumpQuantity->jumpWeights = jumpWeights;
+		jumpQuantity->jump = jump;
+		quantity = jumpQuantity;
+		box.size.x = 200.0f;
+	}
+	~JumpWeightSlider() {
+		delete quantity;
+	}
+};
+
+struct JumpWeightsResetItem : MenuItem {
+	JumpWeights *jumpWeights;
+	void onAction(event::Action &e) override {
+		jumpWeights->reset();
+	}
+};
+
+void appendJumpWeightsMenu(Menu *menu, JumpWeights *jumpWeights) {
+	MenuLabel *spacerLabel = new MenuLabel();
+	menu->addChild(spacerLabel);
+
+	MenuLabel *jumpsLabel = new MenuLabel();
+	jumpsLabel->text = "Uncertainty jumps";
+	menu->addChild(jumpsLabel);
+	for (int i = 0; i < JumpWeights::NUM_JUMPS; i++)
+		menu->addChild(new JumpWeightSlider(jumpWeights, i));
+
+	JumpWeightsResetItem *resetItem = createMenuItem<JumpWeightsResetItem>("Reset uncertainty jumps", "");
+	resetItem->jumpWeights = jumpWeights;
+	menu->addChild(resetItem);
+}
+
+
+struct ParamBlockSizeItem : MenuItem {
+	int *blockSize;
+	int size;
+	void onAction(event::Action &e) override {
+		*blockSize = size;
+	}
+};
+
+void appendParamBlockSizeMenu(Menu *menu, int *blockSize) {
+	MenuLabel *spacerLabel = new MenuLabel();
+	menu->addChild(spacerLabel);
+
+	MenuLabel *rateLabel = new MenuLabel();
+	rateLabel->text = "Knob and CV control rate";
+	menu->addChild(rateLabel);
+	static const int sizes[4] = {1, 8, 16, 32};
+	for (int i = 0; i < 4; i++) {
+		std::string text = sizes[i] == 1 ? "Every sample" : string::f("Every %i samples, ramped", sizes[i]);
+		ParamBlockSizeItem *sizeItem = createMenuItem<ParamBlockSizeItem>(text, CHECKMARK(*blockSize == sizes[i]));
+		sizeItem->blockSize = blockSize;
+		sizeItem->size = sizes[i];
+		menu->addChild(sizeItem);
+	}
+}
+
+
+void appendThroughputMenu(Menu *menu, int *blockSize, int latency) {
+	MenuLabel *spacerLabel = new MenuLabel();
+	menu->addChild(spacerLabel);
+
+	MenuLabel *throughputLabel = new MenuLabel();
+	throughputLabel->text = latency > 0 ? string::f("Throughput mode (latency %i samples)", latency) : "Throughput mode";
+	menu->addChild(throughputLabel);
+	static const int sizes[3] = {0, 16, 32};
+	for (int i = 0; i < 3; i++) {
+		std::string text = sizes[i] == 0 ? "Off (no latency)" : string::f("Blocks of %i samples", sizes[i]);
+		ParamBlockSizeItem *sizeItem = createMenuItem<ParamBlockSizeItem>(text, CHECKMARK(*blockSize == sizes[i]));
+		sizeItem->blockSize = blockSize;
+		sizeItem->size = sizes[i];
+		menu->addChild(sizeItem);
+	}
+}
+
+#ifdef GEO_DENORMAL_COUNT
+#include <map>
+#include <mutex>
+
+bool DenormalCounters::guardBypassed = false;
+
+// Counters by module, only changed when modules are created or deleted (never from process())
+static std::mutex denormalCountersMutex;
+static std::map<Module*, DenormalCounters*> denormalCountersRegistry;
+
+DenormalCounters::DenormalCounters(Module *_module, std::initializer_list<const char*> _names) {
+	module = _module;
+	numStates = 0;
+	for (const char *name : _names) {
+		assert(numStates < MAX_STATES);
+		names[numStates++] = name;
+	}
+	reset();
+	std::lock_guard<std::mutex> lock(denormalCountersMutex);
+	denormalCountersRegistry[module] = this;
+}
+
+DenormalCounters::~DenormalCounters() {
+	std::lock_guard<std::mutex> lock(denormalCountersMutex);
+	denormalCountersRegistry.erase(module);
+}
+
+void DenormalCounters::reset() {
+	for (int i = 0; i < MAX_STATES; i++) {
+		checks[i].store(0, std::memory_order_relaxed);
+		denormals[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+DenormalCounters *getDenormalCounters(Module *module) {
+	std::lock_guard<std::mutex> lock(denormalCountersMutex);
+	std::map<Module*, DenormalCounters*>::iterator it = denormalCountersRegistry.find(module);
+	return it == denormalCountersRegistry.end() ? NULL : it->second;
+}
+#endif
+
+
+#ifdef GEO_PROCESS_TIMING
+#include <map>
+#include <mutex>
+
+// Histograms by module, only changed when modules are created or deleted (never from process())
+static std::mutex processTimesMutex;
+static std::map<Module*, ProcessTimeHistogram*> processTimesRegistry;
+
+ProcessTimeHistogram::ProcessTimeHistogram(Module *_module) {
+	module = _module;
+	reset();
+	std::lock_guard<std::mutex> lock(processTimesMutex);
+	processTimesRegistry[module] = this;
+}
+
+ProcessTimeHistogram::~ProcessTimeHistogram() {
+	std::lock_guard<std::mutex> lock(processTimesMutex);
+	processTimesRegistry.erase(module);
+}
+
+void ProcessTimeHistogram::reset() {
+	for (int i = 0; i < NUM_BINS; i++)
+		bins[i].store(0, std::memory_order_relaxed);
+	maxTicks.store(0, std::memory_order_relaxed);
+}
+
+uint64_t ProcessTimeHistogram::getCount() {
+	uint64_t count = 0;
+	for (int i = 0; i < NUM_BINS; i++)
+		count += bins[i].load(std::memory_order_relaxed);
+	return count;
+}
+
+uint64_t ProcessTimeHistogram::getPercentile(float p) {
+	uint64_t count = getCount();
+	if (count == 0)
+		return 0;
+	uint64_t target = (uint64_t)std::ceil(p * (double)count);
+	uint64_t cumul = 0;
+	for (int i = 0; i < NUM_BINS - 1; i++) {
+		cumul += bins[i].load(std::memory_order_relaxed);
+		if (cumul >= target)
+			return ((uint64_t)1) << (i + 1);
+	}
+	return getMax();
 }
 
+ProcessTimeHistogram *getProcessTimes(Module *module) {
+	std::lock_guard<std::mutex> lock(processTimesMutex);
+	std::map<Module*, ProcessTimeHistogram*>::iterator it = processTimesRegistry.find(module);
+	return it == processTimesRegistry.end() ? NULL : it->second;
+}
+
+struct ProcessTimesResetItem : MenuItem {
+	ProcessTimeHistogram *histogram;
+	void onAction(event::Action &e) override {
+		histogram->reset();
+	}
+};
+
+void appendProcessTimesMenu(Menu *menu, Module *module) {
+	ProcessTimeHistogram *histogram = module ? getProcessTimes(module) : NULL;
+	if (!histogram)
+		return;
+	MenuLabel *spacerLabel = new MenuLabel();
+	menu->addChild(spacerLabel);
+
+	MenuLabel *timesLabel = new MenuLabel();
+	timesLabel->text = string::f("process() ticks, %llu calls", (unsigned long long)histogram->getCount());
+	menu->addChild(timesLabel);
+	MenuLabel *percentilesLabel = new MenuLabel();
+	percentilesLabel->text = string::f("p50 <%llu p99 <%llu p999 <%llu max %llu", (unsigned long long)histogram->getPercentile(0.5f), (unsigned long long)histogram->getPercentile(0.99f), (unsigned long long)histogram->getPercentile(0.999f), (unsigned long long)histogram->getMax());
+	menu->addChild(percentilesLabel);
+
+	ProcessTimesResetItem *resetItem = createMenuItem<ProcessTimesResetItem>("Reset process() timing", "");
+	resetItem->histogram = histogram;
+	menu->addChild(resetItem);
+}
+#endif
+
+
 void saveDarkAsDefault(bool darkAsDefault) {
 }
 
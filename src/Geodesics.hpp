@@ -12,8 +12,23 @@
 #ifndef GEODESICS_HPP
 #define GEODESICS_HPP
 
+#include <atomic>
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
 #include "rack.hpp"
 #include "GeoWidgets.hpp"
+#include "GeoMath.hpp"
+#ifdef GEO_DENORMAL_COUNT
+#include <cstring>
+#include <initializer_list>
+#endif
+#ifdef GEO_PROCESS_TIMING
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
 
 
 using namespace rack;
@@ -223,19 +238,57 @@ struct RefreshCounter {
 	static const unsigned int userInputsStepSkipMask = 0xF;// sub interval of displayRefreshStepSkips, since inputs should be more responsive than lights
 	// above value should make it such that inputs are sampled > 1kHz so as to not miss 1ms triggers
 	
-	unsigned int refreshCounter = (random::u32() % displayRefreshStepSkips);// stagger start values to avoid processing peaks when many Geo and Impromptu modules in the patch
+	// Each instance gets a fixed slot (phase) in the plugin-wide 256 sample light cycle, and thus in the 16 sample
+	//   input cycle, chosen by the scheduler in Geodesics.cpp so that the control-rate costs of all Geodesics
+	//   instances are spread evenly over the samples (instead of a random stagger of the start values).
+	//   Each instance counts the engine frames itself, one per processLights() call, so that a frame is never seen
+	//   twice or skipped, whatever the order of the modules and the threads that process them. The counts are kept
+	//   in step through frameCount, where the leader publishes its own count: on Rack's multithreaded engine, the
+	//   leader's call of a frame may come before or after another instance's, so an instance reads frameCount as
+	//   its own count or one less. A difference of 2 or more is a missed frame: an instance behind (bypassed for a
+	//   while) takes the count over, at worst one sample off its slot, and an instance ahead takes the lead over
+	//   from a leader that is not processed any more (bypassed module)
+	unsigned int refreshCounter;
+	unsigned int slot;
+	// Costs of the processInputs() and processLights() work of the module over its other samples, in TSC ticks, given
+	//   by each module as measured by geodesics-bench -c (first scenario of each module, 44.1 kHz); only their
+	//   ratios matter to the scheduler, so that they hold on other CPUs
+	float inputCost;
+	float lightCost;
+	unsigned int frame = 0;// engine frames counted by this instance
+	bool counting = false;// frame is taken from frameCount on the first processLights()
+	static std::atomic<unsigned int> frameCount;// count of the leader, written by the leader only
+	static std::atomic<RefreshCounter*> leader;
+	
+	RefreshCounter(float _inputCost = 50.0f, float _lightCost = 100.0f);
+	~RefreshCounter();
+	RefreshCounter(const RefreshCounter&) = delete;
+	void operator=(const RefreshCounter&) = delete;
 	
 	bool processInputs() {
 		return ((refreshCounter & userInputsStepSkipMask) == 0);
 	}
-	bool processLights() {// this must be called even if module has no lights, since counter is decremented here
-		refreshCounter++;
-		bool process = refreshCounter >= displayRefreshStepSkips;
-		if (process) {
-			refreshCounter = 0;
+	bool processLights() {// this must be called even if module has no lights, since counter is updated here
+		unsigned int shared = frameCount.load(std::memory_order_relaxed);
+		if (!counting) {
+			frame = shared;
+			counting = true;
 		}
-		return process;
+		frame++;
+		RefreshCounter *currentLeader = leader.load(std::memory_order_relaxed);
+		if (currentLeader == this)
+			frameCount.store(frame, std::memory_order_relaxed);
+		else {
+			int lag = (int)(shared - frame);// -1 or 0 when in step
+			if (lag >= 2)
+				frame = shared;
+			else if (lag <= -2)
+				takeLead(currentLeader);
+		}
+		refreshCounter = (slot + frame + 1) % displayRefreshStepSkips;
+		return refreshCounter == 0;
 	}
+	void takeLead(RefreshCounter *currentLeader);
 };
 
 
@@ -243,7 +296,187 @@ struct Trigger : dsp::SchmittTrigger {
 	// implements a 0.1V - 1.0V SchmittTrigger (include/dsp/digital.hpp) instead of 
 	//   calling SchmittTriggerInstance.process(math::rescale(in, 0.1f, 1.f, 0.f, 1.f))
 	bool process(float in);
-};	
+};
+
+
+template <int N>
+struct TriggerBank {
+	// N of the Trigger above, compared 4 at a time in SIMD lanes and kept as bitmasks (bit i for trigger i).
+	//   Fill values[] then call process(), which returns the rising edges as a bitmask
+	static const int NUM_VECS = (N + 3) / 4;
+
+	float values[NUM_VECS * 4] = {};// unused lanes stay at 0V
+	uint32_t high = 0;// bit set when the trigger is HIGH
+	uint32_t known = 0;// bit clear when the trigger is in the UNKNOWN state (no edge on the first high)
+
+	void reset() {
+		high = 0;
+		known = 0;
+	}
+	void reset(uint32_t mask) {
+		high &= ~mask;
+		known &= ~mask;
+	}
+	uint32_t process() {
+		uint32_t above = 0;// >= 1.0V
+		uint32_t below = 0;// <= 0.1V
+		for (int v = 0; v < NUM_VECS; v++) {
+			simd::float_4 in = simd::float_4::load(&values[v * 4]);
+			above |= simd::movemask(in >= 1.0f) << (v * 4);
+			below |= simd::movemask(in <= 0.1f) << (v * 4);
+		}
+		uint32_t rising = above & ~high & known;
+		high = above | (high & ~below);
+		known |= above | below;
+		return rising;
+	}
+};
+
+
+template <int N>
+struct LightBank {
+	// Brightnesses of N consecutive lights of a module (at most 64), written to the module's lights only when they
+	//   changed. At control rate, fill values[] (or call hold() every sample then takePeaks()), then call
+	//   write(&lights[FIRST_LIGHT]); it compares 4 values at a time in SIMD lanes with the last ones written and
+	//   keeps the differences in the dirty bitmask (bit i for light i). The peaks keep the highest value held since
+	//   the last takePeaks(), so that per-sample lights can move to the light refresh without losing short transients
+	static const int NUM_VECS = (N + 3) / 4;
+	static constexpr uint64_t ALL = (N >= 64 ? ~0ull : ((1ull << (N & 0x3F)) - 1));
+
+	float values[NUM_VECS * 4] = {};// unused lanes stay at 0
+	float written[NUM_VECS * 4] = {};
+	float peaks[NUM_VECS * 4] = {};
+	uint64_t dirty = ALL;// the first write() writes all lights
+
+	void reset() {
+		for (int i = 0; i < NUM_VECS * 4; i++)
+			peaks[i] = 0.0f;
+		dirty = ALL;
+	}
+	void hold(int i, float value) {
+		peaks[i] = std::max(peaks[i], value);
+	}
+	void takePeaks() {
+		for (int v = 0; v < NUM_VECS; v++) {
+			simd::float_4::load(&peaks[v * 4]).store(&values[v * 4]);
+			simd::float_4::zero().store(&peaks[v * 4]);
+		}
+	}
+	void write(Light *lights) {
+		for (int v = 0; v < NUM_VECS; v++) {
+			simd::float_4 changed = simd::float_4::load(&values[v * 4]) != simd::float_4::load(&written[v * 4]);
+			dirty |= (uint64_t)simd::movemask(changed) << (v * 4);
+		}
+		for (uint64_t bits = dirty & ALL; bits != 0; bits &= bits - 1) {
+			int i = __builtin_ctzll(bits);
+			lights[i].setBrightness(values[i]);
+			written[i] = values[i];
+		}
+		dirty = 0;
+	}
+};
+
+
+struct ConnectionMasks {
+	// Connected state of the inputs and outputs of a module (at most 64 of each) cached as bitmasks (bit i for port i).
+	//   Call process() at control rate; it rescans the ports and calls the module's
+	//   onConnectionsChanged(oldMasks, newMasks) only when a cable was added or removed, so that routing
+	//   tables are rebuilt on cable changes only. The first process() after construction or reset() always
+	//   scans and calls the hook, whatever the control-rate phase.
+	uint64_t inputs = 0;
+	uint64_t outputs = 0;
+	bool known = false;
+
+	void reset() {
+		known = false;
+	}
+	bool isInputConnected(int id) {
+		return (inputs & ((uint64_t)0x1 << id)) != 0;
+	}
+	bool isOutputConnected(int id) {
+		return (outputs & ((uint64_t)0x1 << id)) != 0;
+	}
+	bool operator!=(const ConnectionMasks &other) const {
+		return inputs != other.inputs || outputs != other.outputs;
+	}
+	template<class TModule>
+	void process(TModule *module, bool refresh) {// refresh is usually RefreshCounter::processInputs()
+		if (!refresh && known)
+			return;
+		ConnectionMasks newMasks;
+		newMasks.known = true;
+		for (size_t i = 0; i < module->inputs.size(); i++)
+			newMasks.inputs |= (uint64_t)(module->inputs[i].isConnected() ? 1 : 0) << i;
+		for (size_t i = 0; i < module->outputs.size(); i++)
+			newMasks.outputs |= (uint64_t)(module->outputs[i].isConnected() ? 1 : 0) << i;
+		if (newMasks != *this || !known) {
+			ConnectionMasks oldMasks = *this;
+			*this = newMasks;
+			module->onConnectionsChanged(oldMasks, newMasks);
+		}
+	}
+};
+
+
+struct GeoRandom {
+	// Per-instance xoshiro128++ generator, run as 4 independent streams in SIMD lanes (each state word holds
+	//   the 4 streams) so that blocks are generated 4 values at a time. Modules seed it once from Rack's generator
+	//   and save the seed in their patch data, so that a reloaded patch replays the same random choices (from the
+	//   start of the seeded sequence, not from where it was when saved); see seedFromJson() for duplicated modules.
+	//   Floats use the upper 24 bits: uniform is k / 2^24 in [0, 1), bipolar is k / 2^23 in [-1, 1)
+	simd::int32_4 s[4];
+	uint64_t seedValue;
+	int32_t cache[4];// for the scalar draws
+	int cacheIndex;
+
+	GeoRandom();
+	~GeoRandom();
+	GeoRandom(const GeoRandom&) = delete;// the seeds of the live generators are tracked (see seedFromJson())
+	void operator=(const GeoRandom&) = delete;
+	void seed(uint64_t _seedValue);
+
+	static simd::int32_4 rotl(simd::int32_4 x, int k) {// >> is arithmetic, hence the mask
+		return (x << k) | ((x >> (32 - k)) & simd::int32_4((1 << k) - 1));
+	}
+	simd::int32_4 next() {
+		simd::int32_4 result = rotl(s[0] + s[3], 7) + s[0];
+		simd::int32_4 t = s[1] << 9;
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= t;
+		s[3] = rotl(s[3], 11);
+		return result;
+	}
+	uint32_t u32() {
+		if (cacheIndex >= 4) {
+			next().store(cache);
+			cacheIndex = 0;
+		}
+		return (uint32_t)cache[cacheIndex++];
+	}
+	float uniform() {
+		return (float)(u32() >> 8) * (1.0f / 16777216.0f);
+	}
+	simd::float_4 bipolar4() {// upper 24 bits masked then sign extended, so that it does not depend on how >> shifts
+		simd::int32_4 k = (next() >> 8) & simd::int32_4(0xFFFFFF);
+		return simd::float_4((k ^ simd::int32_4(0x800000)) - simd::int32_4(0x800000)) * (1.0f / 8388608.0f);
+	}
+	void fillBipolar(float *out, int n) {// n must be a multiple of 4
+		for (int i = 0; i < n; i += 4)
+			bipolar4().store(&out[i]);
+	}
+
+	// patch data, as a decimal string since json integers are signed
+	json_t *seedToJson() {
+		return json_string(std::to_string(seedValue).c_str());
+	}
+	// Restarts the sequence of the saved seed. Rack duplicates a module through its json, so a saved seed that another
+	//   live generator already uses is a copy of a module that is still in the patch: a new seed is drawn instead,
+	//   so that the copy does not run in lockstep with the original
+	void seedFromJson(json_t *seedJ);
+};
 
 
 // http://www.earlevel.com/main/2012/12/15/a-one-pole-filter/
@@ -256,7 +489,7 @@ struct OnePoleFilter {
 	// float lastin = 0.0f;
 	
     void setCutoff(float Fc) {
-		b1 = std::exp(-2.0f * M_PI * Fc);
+		b1 = fastExp(-2.0f * (float)M_PI * Fc);
 	}
     float process(float in) {
 		// lastin = in;
@@ -271,6 +504,165 @@ struct OnePoleFilter {
 };
 
 
+template<int N>
+struct OnePoleFilterBank {
+	// N of the OnePoleFilter above, 4 per vector in SIMD lanes (filter i is lane i & 0x3 of vector i >> 2), with
+	//   the same arithmetic so that a lane gives the same output as the scalar filter. Call process() on each
+	//   vector, then read lowpass() and highpass() (input - lowpass). States that decay below denormalThreshold on
+	//   quiet inputs are flushed to 0, so that they never reach the slow denormal range
+	static const int NUM_VECS = (N + 3) / 4;
+	static constexpr float denormalThreshold = 1e-30f;
+
+	simd::float_4 b1[NUM_VECS];
+	simd::float_4 a0[NUM_VECS];// 1 - b1
+	simd::float_4 lowout[NUM_VECS];
+	simd::float_4 lastin[NUM_VECS];
+
+	OnePoleFilterBank() {
+		for (int v = 0; v < NUM_VECS; v++) {
+			b1[v] = simd::float_4::zero();
+			a0[v] = 1.0f;
+			lowout[v] = simd::float_4::zero();
+			lastin[v] = simd::float_4::zero();
+		}
+	}
+	void setCutoff(int i, float Fc) {
+		float b = fastExp(-2.0f * (float)M_PI * Fc);
+		b1[i >> 2][i & 0x3] = b;
+		a0[i >> 2][i & 0x3] = 1.0f - b;
+	}
+	void setCutoffAll(float Fc) {
+		simd::float_4 b = fastExp(simd::float_4(-2.0f * (float)M_PI * Fc));
+		for (int v = 0; v < NUM_VECS; v++) {
+			b1[v] = b;
+			a0[v] = 1.0f - b;
+		}
+	}
+	simd::float_4 process(int v, simd::float_4 in) {// returns the lowpass
+		lastin[v] = in;
+		simd::float_4 out = in * a0[v] + lowout[v] * b1[v];
+		return lowout[v] = simd::ifelse(simd::fabs(out) < denormalThreshold, simd::float_4::zero(), out);
+	}
+	simd::float_4 lowpass(int v) {
+		return lowout[v];
+	}
+	simd::float_4 highpass(int v) {
+		return lastin[v] - lowout[v];
+	}
+};
+
+
+template<int N>
+struct ParamRamps {
+	// N control values (knobs and slow CV, after their clamp, pow, round...) evaluated once per block of blockSize
+	//   samples and linearly ramped per sample in between, in SIMD lanes (ramp i is lane i & 0x3 of vector i >> 2).
+	//   When isBlockStart(), fill targets[] and call start(); then call next() every sample and read get(i).
+	//   A ramp ends exactly on its target, one block after the controls were read. A blockSize of 1 evaluates
+	//   every sample without ramps, and is the default since CV inputs can be patched at audio rate; larger blocks
+	//   are opt-in from the context menu
+	static const int NUM_VECS = (N + 3) / 4;
+	static const int DEFAULT_BLOCK_SIZE = 1;
+	
+	int blockSize = DEFAULT_BLOCK_SIZE;// can be changed by the UI thread, taken at the next block
+	int counter = 0;// samples left in the block
+	bool started = false;// first block jumps to the targets
+	float targets[NUM_VECS * 4] = {};
+	simd::float_4 values[NUM_VECS];
+	simd::float_4 steps[NUM_VECS];
+	
+	bool isBlockStart() {
+		return counter <= 0;
+	}
+	void start() {
+		start(std::max(blockSize, 1));
+	}
+	void start(int size) {// a block of the given size instead of blockSize (throughput mode kernels)
+		for (int v = 0; v < NUM_VECS; v++) {
+			simd::float_4 target = simd::float_4::load(&targets[v * 4]);
+			if (!started || size == 1) {
+				values[v] = target;
+				steps[v] = simd::float_4::zero();
+			}
+			else
+				steps[v] = (target - values[v]) / (float)size;
+		}
+		counter = size;
+		started = true;
+	}
+	void next() {
+		counter--;
+		for (int v = 0; v < NUM_VECS; v++)
+			values[v] = counter <= 0 ? simd::float_4::load(&targets[v * 4]) : values[v] + steps[v];
+	}
+	float get(int i) {
+		return values[i >> 2][i & 0x3];
+	}
+	float getStep(int i) {// per sample, so that a block kernel can ramp value i itself: get(i) + getStep(i) * n
+		return steps[i >> 2][i & 0x3];
+	}
+	void skip(int n) {// n calls of next() at once, after a block kernel did the ramps
+		counter -= n;
+		for (int v = 0; v < NUM_VECS; v++)
+			values[v] = counter <= 0 ? simd::float_4::load(&targets[v * 4]) : values[v] + steps[v] * (float)n;
+	}
+	void reset() {
+		counter = 0;
+		started = false;
+	}
+	static int normalizeBlockSize(int size) {// to the sizes of the menu (1, 8, 16 or 32), for the values read from json
+		return size >= 32 ? 32 : size >= 16 ? 16 : size >= 8 ? 8 : 1;
+	}
+};
+
+
+template<int NUM_INS, int NUM_OUTS>
+struct ThroughputBlock {
+	// Opt-in block processing of a module (throughput mode, for CV patches where latency is not an issue): the per-sample
+	//   values of NUM_INS inputs are collected in ins[] while NUM_OUTS outputs are played back from outs[], and the
+	//   module's block kernel runs once per block on the collected inputs to fill outs[] for the next block. The outputs
+	//   are thus late by one block, declared by getLatency(). Every sample, when sync() is true, fill ins[i][pos] then
+	//   call next(), and run the kernel on size samples when it returns true. A blockSize of 0 is off (per-sample
+	//   process()); a change of blockSize restarts the blocks, holding the outputs for the first one
+	static const int MAX_BLOCK_SIZE = 32;
+	
+	int blockSize = 0;// 0 (off), 16 or 32; can be changed by the UI thread, taken at the next block
+	int size = 0;// of the blocks in progress, 0 when off
+	int pos = 0;// sample in the block
+	alignas(16) float ins[NUM_INS][MAX_BLOCK_SIZE];
+	alignas(16) float outs[NUM_OUTS][MAX_BLOCK_SIZE];
+	
+	bool sync(Output *outputs) {// outputs are the NUM_OUTS played back, their current voltages are held when (re)starting
+		int newSize = normalizeBlockSize(blockSize);
+		if (pos == 0 && size != newSize) {
+			size = newSize;
+			for (int o = 0; o < NUM_OUTS; o++) {
+				for (int s = 0; s < size; s++)
+					outs[o][s] = outputs[o].getVoltage();
+			}
+		}
+		return size > 0;
+	}
+	bool next(Output *outputs) {// true when ins[] has a full block
+		for (int o = 0; o < NUM_OUTS; o++)
+			outputs[o].setVoltage(outs[o][pos]);
+		if (++pos < size)
+			return false;
+		pos = 0;
+		return true;
+	}
+	int getLatency() {// in samples
+		return size;
+	}
+	void reset() {
+		size = 0;
+		pos = 0;
+	}
+	static int normalizeBlockSize(int size) {// to the sizes of the menu (0, 16 or 32), kernels work 4 samples at a time
+		return size >= 32 ? 32 : size >= 16 ? 16 : 0;
+	}
+};
+
+
 struct HoldDetect {
 	long modeHoldDetect;// 0 when not detecting, downward counter when detecting
 	
@@ -285,7 +677,227 @@ struct HoldDetect {
 	bool process(float paramValue);
 };
 
-int getWeighted1to8random();
+
+template<int N>
+struct AliasTable {
+	// Walker's alias method (Vose's construction): draws outcome 0 to N-1 of a discrete distribution in constant time.
+	//   A single uniform draw picks a column with its integer part and, with its fraction, the column or its alias.
+	//   build() is O(N) and is only called when the weights change, never in process()
+	float prob[N];
+	int alias[N];
+	
+	void build(const float *weights) {// weights need not be normalized, negative ones count as 0
+		float sum = 0.0f;
+		for (int i = 0; i < N; i++)
+			sum += std::max(weights[i], 0.0f);
+		float scaled[N];
+		int small[N];
+		int large[N];
+		int numSmall = 0;
+		int numLarge = 0;
+		for (int i = 0; i < N; i++) {
+			scaled[i] = sum > 0.0f ? std::max(weights[i], 0.0f) * N / sum : 1.0f;// all zero is uniform
+			if (scaled[i] < 1.0f)
+				small[numSmall++] = i;
+			else
+				large[numLarge++] = i;
+		}
+		while (numSmall > 0 && numLarge > 0) {
+			int s = small[--numSmall];
+			int l = large[--numLarge];
+			prob[s] = scaled[s];
+			alias[s] = l;
+			scaled[l] = (scaled[l] + scaled[s]) - 1.0f;
+			if (scaled[l] < 1.0f)
+				small[numSmall++] = l;
+			else
+				large[numLarge++] = l;
+		}
+		while (numLarge > 0) {
+			int l = large[--numLarge];
+			prob[l] = 1.0f;
+			alias[l] = l;
+		}
+		while (numSmall > 0) {// only from rounding
+			int s = small[--numSmall];
+			prob[s] = 1.0f;
+			alias[s] = s;
+		}
+	}
+	int sample(GeoRandom &rng) {
+		float x = rng.uniform() * N;
+		int i = std::min((int)x, N - 1);
+		return (x - (float)i) < prob[i] ? i : alias[i];
+	}
+};
+
+
+struct JumpWeights {
+	// Distribution of the uncertainty jumps of 1 to 8 steps (Ions and Entropia), editable in the context menu and
+	//   saved with the patch. The UI thread rebuilds the table in place; a draw during a rebuild can only see a mix
+	//   of the old and new distributions, since every entry is valid at all times
+	static const int NUM_JUMPS = 8;
+	static constexpr float defaultWeights[NUM_JUMPS] = {175.0f, 155.0f, 145.0f, 135.0f, 115.0f, 105.0f, 95.0f, 75.0f};// per mille
+	float weights[NUM_JUMPS];
+	AliasTable<NUM_JUMPS> table;
+	
+	JumpWeights() {
+		reset();
+	}
+	void reset() {
+		for (int i = 0; i < NUM_JUMPS; i++)
+			weights[i] = defaultWeights[i];
+		table.build(weights);
+	}
+	void setWeight(int i, float weight) {
+		weights[i] = weight;
+		table.build(weights);
+	}
+	float getProbability(int i);
+	int sample(GeoRandom &rng) {// 1 to 8
+		return table.sample(rng) + 1;
+	}
+	
+	json_t *toJson();
+	void fromJson(json_t *weightsJ);
+};
+
+void appendJumpWeightsMenu(Menu *menu, JumpWeights *jumpWeights);
+void appendParamBlockSizeMenu(Menu *menu, int *blockSize);// for ParamRamps::blockSize
+void appendThroughputMenu(Menu *menu, int *blockSize, int latency);// for ThroughputBlock::blockSize
+
+
+#ifdef GEO_DENORMAL_COUNT
+// Opt-in build (make GEO_DENORMAL_COUNT=1): how often the recursive filter states of a module instance hold denormal
+//   values, per named state (lane by lane for vectors). The audio thread is the only writer (relaxed atomics), the
+//   UI thread or the bench read or reset them at any time. Denormals are found from the float bits, since the
+//   comparisons of a DAZ unit see them as 0
+struct DenormalCounters {
+	static const int MAX_STATES = 8;
+	static bool guardBypassed;// the bench can turn the DenormalGuard off to see the states it protects
+	const char *names[MAX_STATES] = {};
+	std::atomic<uint64_t> checks[MAX_STATES];
+	std::atomic<uint64_t> denormals[MAX_STATES];
+	int numStates;
+	Module *module;
+	
+	DenormalCounters(Module *_module, std::initializer_list<const char*> _names);// registers the counters so that getDenormalCounters(module) finds them
+	~DenormalCounters();
+	
+	static bool isDenormal(float value) {
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return (bits & 0x7F800000) == 0 && (bits & 0x007FFFFF) != 0;
+	}
+	void check(int state, float value) {
+		checks[state].fetch_add(1, std::memory_order_relaxed);
+		if (isDenormal(value))
+			denormals[state].fetch_add(1, std::memory_order_relaxed);
+	}
+	void check(int state, simd::float_4 value) {
+		for (int i = 0; i < 4; i++)
+			check(state, value[i]);
+	}
+	void reset();
+};
+
+DenormalCounters *getDenormalCounters(Module *module);// NULL when the module has no counters
+#endif
+
+
+// Sets the flush-to-zero and denormals-are-zero modes for its scope and restores the caller's modes on exit, so that
+//   the recursive filter states that decay toward 0 on silent inputs never take the slow denormal paths. Declare it
+//   at the top of process(), after the ProcessTimer. Rack's engine thread usually has the modes set already, in
+//   which case the guard only reads the control register
+//   The reference build of the bench (GEO_REFERENCE_MATH, see bench/Golden.cpp) keeps the IEEE denormals
+struct DenormalGuard {
+#if defined(GEO_REFERENCE_MATH)
+	DenormalGuard() {}
+#elif defined(__SSE__)
+	static const unsigned int FTZ_DAZ = 0x8040;// MXCSR bits 15 and 6
+	unsigned int savedCsr;
+	
+	DenormalGuard() {
+		savedCsr = _mm_getcsr();
+#ifdef GEO_DENORMAL_COUNT
+		if (DenormalCounters::guardBypassed)
+			return;
+#endif
+		if ((savedCsr & FTZ_DAZ) != FTZ_DAZ)
+			_mm_setcsr(savedCsr | FTZ_DAZ);
+	}
+	~DenormalGuard() {
+		if ((savedCsr & FTZ_DAZ) != FTZ_DAZ)
+			_mm_setcsr(savedCsr);
+	}
+#elif defined(__aarch64__)
+	static const uint64_t FZ = ((uint64_t)1) << 24;// FPCR bit 24, flushes both inputs and outputs
+	uint64_t savedFpcr;
+	
+	DenormalGuard() {
+		__asm__ __volatile__("mrs %0, fpcr" : "=r"(savedFpcr));
+#ifdef GEO_DENORMAL_COUNT
+		if (DenormalCounters::guardBypassed)
+			return;
+#endif
+		if ((savedFpcr & FZ) == 0)
+			__asm__ __volatile__("msr fpcr, %0" : : "r"(savedFpcr | FZ));
+	}
+	~DenormalGuard() {
+		if ((savedFpcr & FZ) == 0)
+			__asm__ __volatile__("msr fpcr, %0" : : "r"(savedFpcr));
+	}
+#endif
+};
+
+
+#ifdef GEO_PROCESS_TIMING
+// Opt-in build (make GEO_PROCESS_TIMING=1): duration of every process() call in a log2 histogram per module instance.
+//   Durations are in TSC ticks (nanoseconds on non x86 targets). The audio thread is the only writer and updates
+//   the bins with relaxed atomics, so that the UI thread can read or reset them at any time without a lock.
+struct ProcessTimeHistogram {
+	static const int NUM_BINS = 64;// bin i holds durations in [2^i, 2^(i+1)), bin 0 also holds 0
+	std::atomic<uint32_t> bins[NUM_BINS];
+	std::atomic<uint64_t> maxTicks;
+	Module *module;
+	
+	ProcessTimeHistogram(Module *_module);// registers the histogram so that getProcessTimes(module) finds it
+	~ProcessTimeHistogram();
+	
+	static uint64_t readTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+	void add(uint64_t ticks) {
+		int bin = ticks == 0 ? 0 : 63 - __builtin_clzll(ticks);
+		bins[bin].fetch_add(1, std::memory_order_relaxed);
+		if (ticks > maxTicks.load(std::memory_order_relaxed))
+			maxTicks.store(ticks, std::memory_order_relaxed);
+	}
+	void reset();
+	uint64_t getCount();
+	uint64_t getPercentile(float p);// upper bound of the bin that holds the given fraction of calls, 0 when empty
+	uint64_t getMax() {return maxTicks.load(std::memory_order_relaxed);}
+};
+
+struct ProcessTimer {// times its own scope, declare it first in process()
+	ProcessTimeHistogram &histogram;
+	uint64_t start;
+	
+	ProcessTimer(ProcessTimeHistogram &_histogram) : histogram(_histogram) {
+		start = ProcessTimeHistogram::readTicks();
+	}
+	~ProcessTimer() {
+		histogram.add(ProcessTimeHistogram::readTicks() - start);
+	}
+};
+
+ProcessTimeHistogram *getProcessTimes(Module *module);// NULL when the module has no histogram
+void appendProcessTimesMenu(Menu *menu, Module *module);
+#endif
 
 
 void saveDarkAsDefault(bool darkAsDefault);
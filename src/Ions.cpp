@@ -70,9 +70,11 @@ struct Ions : Module {
 
 	// Need to save, no reset
 	int panelTheme;
+	GeoRandom rng;
 							  
 	// Need to save, with reset
 	bool running;
+	JumpWeights jumpWeights;// distribution of the uncertainty jumps
 	bool resetOnRun;
 	int quantize;// a.k.a. plank constant, bit0 = blue, bit1 = yellow
 	bool uncertainty;
@@ -89,25 +91,18 @@ struct Ions : Module {
 	float resetLight = 0.0f;
 	float jumpLights[2] = {0.0f, 0.0f};
 	float stepClocksLight = 0.0f;
+	LightBank<32> stepLights;// BLUE 0-15, YELLOW 16-31
 	Trigger runningTrigger;
-	Trigger clockTrigger;
-	Trigger clocksTriggers[2];
+	TriggerBank<3> clockTriggers;// global 0, local 1-2
 	Trigger resetTrigger;
-	Trigger stateTriggers[2];
-	Trigger octTriggers[2];
-	Trigger stateCVTriggers[2];
-	Trigger leapTrigger;
-	Trigger plankTrigger;
-	Trigger plank2Trigger;
-	Trigger uncertaintyTrigger;
-	Trigger resetOnRunTrigger;
+	TriggerBank<9> buttonTriggers;// state 0-1, oct 2-3, leap 4, plank 5, plank2 6, uncertainty 7, reset on run 8
 	Trigger stepClocksTrigger;
 	dsp::PulseGenerator jumpPulses[2];
-	RefreshCounter refresh;
+	RefreshCounter refresh{40.0f, 96.0f};
 
 	
 	inline float quantizeCV(float cv) {return std::round(cv * 12.0f) / 12.0f;}
-	inline bool jumpRandom() {return (random::uniform() < (params[PROB_PARAM].getValue() + inputs[PROB_INPUT].getVoltage() / 10.0f));}// randomUniform is [0.0, 1.0)
+	inline bool jumpRandom() {return (rng.uniform() < (params[PROB_PARAM].getValue() + inputs[PROB_INPUT].getVoltage() / 10.0f));}// randomUniform is [0.0, 1.0)
 	
 	
 	Ions() {
@@ -137,6 +132,7 @@ struct Ions : Module {
 		configParam(LEAP_PARAM, 0.0f, 1.0f, 0.0f, "Quantum leap");	
 		configParam(UNCERTANTY_PARAM, 0.0f, 1.0f, 0.0f, "Uncertainty");	
 
+		rng.seed(random::u64());
 		onReset();
 
 		panelTheme = (loadDarkAsDefault() ? 1 : 0);
@@ -145,6 +141,7 @@ struct Ions : Module {
 	
 	void onReset() override {
 		running = true;
+		jumpWeights.reset();
 		resetOnRun = false;
 		quantize = 3;
 		uncertainty = false;
@@ -180,6 +177,9 @@ struct Ions : Module {
 		// panelTheme
 		json_object_set_new(rootJ, "panelTheme", json_integer(panelTheme));
 
+		// randomSeed
+		json_object_set_new(rootJ, "randomSeed", rng.seedToJson());
+
 		// running
 		json_object_set_new(rootJ, "running", json_boolean(running));
 
@@ -207,6 +207,9 @@ struct Ions : Module {
 		// leap
 		json_object_set_new(rootJ, "leap", json_boolean(leap));
 
+		// jumpWeights
+		json_object_set_new(rootJ, "jumpWeights", jumpWeights.toJson());
+
 		return rootJ;
 	}
 
@@ -217,6 +220,9 @@ struct Ions : Module {
 		if (panelThemeJ)
 			panelTheme = json_integer_value(panelThemeJ);
 
+		// randomSeed
+		rng.seedFromJson(json_object_get(rootJ, "randomSeed"));
+
 		// running
 		json_t *runningJ = json_object_get(rootJ, "running");
 		if (runningJ)
@@ -266,11 +272,22 @@ struct Ions : Module {
 		if (leapJ)
 			leap = json_is_true(leapJ);
 
+		// jumpWeights
+		jumpWeights.fromJson(json_object_get(rootJ, "jumpWeights"));
+
 		resetNonJson(false);// soft init, don't want to init stepIndexes
 	}
 
 	
+#ifdef GEO_PROCESS_TIMING
+	ProcessTimeHistogram processTimes{this};
+#endif
+	
 	void process(const ProcessArgs &args) override {
+#ifdef GEO_PROCESS_TIMING
+		ProcessTimer processTimer(processTimes);
+#endif
+		DenormalGuard denormalGuard;
 	
 		//********** Buttons, knobs, switches and inputs **********
 	
@@ -285,30 +302,41 @@ struct Ions : Module {
 		}
 		
 		if (refresh.processInputs()) {
+			for (int i = 0; i < 2; i++) {
+				buttonTriggers.values[0 + i] = params[STATE_PARAMS + i].getValue();
+				buttonTriggers.values[2 + i] = params[OCT_PARAMS + i].getValue();
+			}
+			buttonTriggers.values[4] = params[LEAP_PARAM].getValue() + inputs[LEAP_INPUT].getVoltage();
+			buttonTriggers.values[5] = params[PLANK_PARAM].getValue();
+			buttonTriggers.values[6] = params[PLANK2_PARAM].getValue();
+			buttonTriggers.values[7] = params[UNCERTANTY_PARAM].getValue() + inputs[UNCERTANTY_INPUT].getVoltage();
+			buttonTriggers.values[8] = params[RESETONRUN_PARAM].getValue();
+			uint32_t buttonTrigs = buttonTriggers.process();
+			
 			// Leap button
-			if (leapTrigger.process(params[LEAP_PARAM].getValue() + inputs[LEAP_INPUT].getVoltage())) {
+			if ((buttonTrigs & (0x1 << 4)) != 0) {
 				leap = !leap;
 			}
 
 			// Plank buttons (quatize)
-			if (plankTrigger.process(params[PLANK_PARAM].getValue()))
+			if ((buttonTrigs & (0x1 << 5)) != 0)
 				quantize ^= 0x1;
-			if (plank2Trigger.process(params[PLANK2_PARAM].getValue()))
+			if ((buttonTrigs & (0x1 << 6)) != 0)
 				quantize ^= 0x2;
 
 			// uncertainty button
-			if (uncertaintyTrigger.process(params[UNCERTANTY_PARAM].getValue() + inputs[UNCERTANTY_INPUT].getVoltage())) {
+			if ((buttonTrigs & (0x1 << 7)) != 0) {
 				uncertainty = !uncertainty;
 			}
 
 			// Reset on Run button
-			if (resetOnRunTrigger.process(params[RESETONRUN_PARAM].getValue())) {
+			if ((buttonTrigs & (0x1 << 8)) != 0) {
 				resetOnRun = !resetOnRun;
 			}
 
 			// State buttons and CV inputs (state: 0 = global, 1 = local, 2 = both)
 			for (int i = 0; i < 2; i++) {
-				int stateTrig = stateTriggers[i].process(params[STATE_PARAMS + i].getValue());
+				bool stateTrig = (buttonTrigs & (0x1 << (0 + i))) != 0;
 				if (inputs[STATECV_INPUTS + i].isConnected()) {
 					if (inputs[STATECV_INPUTS + i].getVoltage() <= -1.0f)
 						states[i] = 1;
@@ -326,7 +354,7 @@ struct Ions : Module {
 			
 			// Range buttons and CV inputs
 			for (int i = 0; i < 2; i++) {
-				bool rangeTrig = octTriggers[i].process(params[OCT_PARAMS + i].getValue());
+				bool rangeTrig = (buttonTrigs & (0x1 << (2 + i))) != 0;
 				if (inputs[OCTCV_INPUTS + i].isConnected()) {
 					if (inputs[OCTCV_INPUTS + i].getVoltage() <= -1.0f)
 						ranges[i] = 0;
@@ -359,20 +387,26 @@ struct Ions : Module {
 		
 		// Clocks
 		bool stepClocksTrig = stepClocksTrigger.process(params[STEPCLOCKS_PARAM].getValue());
-		bool globalClockTrig = false;
-		if (running && clockIgnoreOnReset == 0l)
-			globalClockTrig = clockTrigger.process(inputs[CLK_INPUT].getVoltage());// keep outside of loop, only need to call once per step()
+		uint32_t clockTrigs = 0;
+		if (running && clockIgnoreOnReset == 0l) {// keep outside of loop, only need to call once per step()
+			clockTriggers.values[0] = inputs[CLK_INPUT].getVoltage();
+			clockTriggers.values[1] = inputs[CLK_INPUTS + 0].getVoltage();
+			clockTriggers.values[2] = inputs[CLK_INPUTS + 1].getVoltage();
+			clockTrigs = clockTriggers.process();
+		}
+		bool globalClockTrig = (clockTrigs & 0x1) != 0;
 		for (int i = 0; i < 2; i++) {
 			int jumpCount = 0;
 			
 			if (running && clockIgnoreOnReset == 0l) {	
 				
 				// Local clocks and uncertainty
-				bool localClockTrig = clocksTriggers[i].process(inputs[CLK_INPUTS + i].getVoltage());
+				bool localClockTrig = (clockTrigs & (0x1 << (1 + i))) != 0;
 				localClockTrig &= (states[i] >= 1);
 				if (localClockTrig) {
 					if (uncertainty) {// local clock modified by uncertainty
-						for (int n = 0; n < getWeighted1to8random(); n++)
+						int jumps = jumpWeights.sample(rng);// drawn once, not in the loop condition
+						for (int n = 0; n < jumps; n++)
 							jumpCount += stepElectron(i, leap);
 					}
 					else 
@@ -404,9 +438,7 @@ struct Ions : Module {
 		if (resetTrigger.process(inputs[RESET_INPUT].getVoltage() + params[RESET_PARAM].getValue())) {
 			initRun(true);
 			resetLight = 1.0f;
-			clockTrigger.reset();
-			clocksTriggers[0].reset();
-			clocksTriggers[1].reset();
+			clockTriggers.reset();
 		}
 		
 		
@@ -434,9 +466,10 @@ struct Ions : Module {
 			float deltaTime = args.sampleTime * (RefreshCounter::displayRefreshStepSkips >> 2);
 			// Blue and Yellow lights
 			for (int i = 0; i < 16; i++) {
-				lights[BLUE_LIGHTS + i].setBrightness(stepIndexes[0] == i ? 1.0f : 0.0f);
-				lights[YELLOW_LIGHTS + i].setBrightness(stepIndexes[1] == i ? 1.0f : 0.0f);
+				stepLights.values[i] = (stepIndexes[0] == i ? 1.0f : 0.0f);
+				stepLights.values[16 + i] = (stepIndexes[1] == i ? 1.0f : 0.0f);
 			}
+			stepLights.write(&lights[BLUE_LIGHTS]);// YELLOW_LIGHTS follow, only the steps that moved are written
 			
 			// Reset light
 			lights[RESET_LIGHT].setSmoothBrightness(resetLight, deltaTime);	
@@ -499,6 +532,17 @@ struct Ions : Module {
 
 
 struct IonsWidget : ModuleWidget {
+	void appendContextMenu(Menu *menu) override {
+		Ions *module = dynamic_cast<Ions*>(this->module);
+		assert(module);
+		
+		appendJumpWeightsMenu(menu, &module->jumpWeights);
+		
+#ifdef GEO_PROCESS_TIMING
+		appendProcessTimesMenu(menu, module);
+#endif
+	}
+	
 	IonsWidget(Ions *module) {
 		setModule(module);
 
@@ -52,6 +52,7 @@ struct Pulsars : Module {
 	
 	// Need to save, no reset
 	int panelTheme;
+	GeoRandom rng;
 	
 	// Need to save, with reset
 	int cvModes[2];// 0 is -5v to 5v, 1 is 0v to 10v, 2 is new ALL mode (0-10V); index 0 is upper Pulsar, index 1 is lower Pulsar
@@ -66,17 +67,22 @@ struct Pulsars : Module {
 	bool topCross[2];
 	int index[2];// always between 0 and 7
 	int indexNext[2];// always between 0 and 7
+	ConnectionMasks connections;
+	typedef void (Pulsars::*PulsarKernel)(float lfoIn);
+	PulsarKernel pulsarKernels[2];// processPulsar() of the modes of each pulsar, set by updateKernels()
 	
 	
 	// No need to save, no reset
-	Trigger voidTriggers[2];
-	Trigger revTriggers[2];
-	Trigger rndTriggers[2];
-	Trigger cvLevelTriggers[2];
+	TriggerBank<8> buttonTriggers;// void 0-1, reverse 2-3, random 4-5, cv level 6-7
 	float lfoLights[2] = {0.0f, 0.0f};
-	RefreshCounter refresh;
+	LightBank<16> mixLights;// MIXA 0-7, MIXB 8-15, peaks held every sample
+	RefreshCounter refresh{42.0f, 96.0f};
 
 	
+	void onConnectionsChanged(const ConnectionMasks &oldMasks, const ConnectionMasks &newMasks) {
+		updateConnected();
+	}
+	
 	void updateConnected() {
 		// builds packed list of connected ports for both pulsars, can be empty list with num = 0
 		// this method takes care of isVoid and isReverse
@@ -86,13 +92,13 @@ struct Pulsars : Module {
 		for (int i = 0; i < 8; i++) {
 			// Pulsar A
 			int irA = isReverse[0] ? ((8 - i) & 0x7) : i;
-			if (isVoid[0] || inputs[INA_INPUTS + irA].isConnected()) {
+			if (isVoid[0] || connections.isInputConnected(INA_INPUTS + irA)) {
 				connected[0][connectedNum[0]] = irA;
 				connectedNum[0]++;
 			}
 			// Pulsar B
 			int irB = isReverse[1] ? ((8 - i) & 0x7) : i;
-			if (isVoid[1] || outputs[OUTB_OUTPUTS + irB].isConnected()) {
+			if (isVoid[1] || connections.isOutputConnected(OUTB_OUTPUTS + irB)) {
 				connected[1][connectedNum[1]] = irB;
 				connectedNum[1]++;
 			}
@@ -104,6 +110,15 @@ struct Pulsars : Module {
 		}
 	}
 	
+	void holdMixLights(int base, int i, int iNext, float percent, float nextPercent) {
+		if (i == iNext)
+			mixLights.hold(base + i, percent + nextPercent);
+		else {
+			mixLights.hold(base + i, percent);
+			mixLights.hold(base + iNext, nextPercent);
+		}
+	}
+	
 	void updateConnectedRand(int bnum) {
 		int tmpList[7];
 		connectedRand[bnum][0] = connected[bnum][0];// first element is always the same (no random)
@@ -115,20 +130,35 @@ struct Pulsars : Module {
 			tmpList[i - 1] = connected[bnum][i];
 		}
 		for (int i = connectedNum[bnum] - 2; i >= 0; i--) {
-			int pickIndex = (random::u32() % (i + 1));
+			int pickIndex = (rng.u32() % (i + 1));
 			connectedRand[bnum][connectedRandNum] = tmpList[pickIndex];
 			connectedRandNum++;
 			tmpList[pickIndex] = tmpList[i];
 		}
 	}
 	
+	void updateKernels() {// call when cvModes[] or isRandom[] change
+		static const PulsarKernel kernels[2][3][2] = {
+			{{&Pulsars::processPulsar<0, 0, false>, &Pulsars::processPulsar<0, 0, true>},
+			 {&Pulsars::processPulsar<0, 1, false>, &Pulsars::processPulsar<0, 1, true>},
+			 {&Pulsars::processPulsar<0, 2, false>, &Pulsars::processPulsar<0, 2, true>}},
+			{{&Pulsars::processPulsar<1, 0, false>, &Pulsars::processPulsar<1, 0, true>},
+			 {&Pulsars::processPulsar<1, 1, false>, &Pulsars::processPulsar<1, 1, true>},
+			 {&Pulsars::processPulsar<1, 2, false>, &Pulsars::processPulsar<1, 2, true>}},
+		};
+		for (int i = 0; i < 2; i++) {
+			int cvMode = cvModes[i] == 0 ? 0 : (cvModes[i] < 2 ? 1 : 2);
+			pulsarKernels[i] = kernels[i][cvMode][isRandom[i] ? 1 : 0];
+		}
+	}
+	
 	void updateIndexNext(int bnum) {// brane number to update, 0 is upper, 1 is lower
 		if (connectedNum[bnum] <= 1) {
 			indexNext[bnum] = 0;
 		}
 		else {
 			if (isRandom[bnum]) {
-				indexNext[bnum] = random::u32() % (connectedNum[bnum] - 1);
+				indexNext[bnum] = rng.u32() % (connectedNum[bnum] - 1);
 				if (indexNext[bnum] == index[bnum])
 					indexNext[bnum] = connectedNum[bnum] - 1;							
 			}
@@ -151,6 +181,7 @@ struct Pulsars : Module {
 		configParam(RND_PARAMS + 1, 0.0f, 1.0f, 0.0f, "Bottom pulsar random");		
 		configParam(CVLEVEL_PARAMS + 1, 0.0f, 1.0f, 0.0f, "Bottom pulsar uni/bi-polar");
 
+		rng.seed(random::u64());
 		onReset();
 
 		panelTheme = (loadDarkAsDefault() ? 1 : 0);
@@ -170,6 +201,8 @@ struct Pulsars : Module {
 		connectedNum[0] = 0;// need this to start change detection to trigger new connectedRand[][] generation
 		connectedNum[1] = 0;// idem
 		updateConnected();// will update connectedRand[][] also if cables connectedNum[x] non-zero
+		connections.reset();// rescan on next process()
+		updateKernels();
 		for (int i = 0; i < 2; i++) {
 			topCross[i] = false;
 			index[i] = 0;
@@ -184,6 +217,7 @@ struct Pulsars : Module {
 			isReverse[i] = (random::u32() % 2) > 0;
 			isRandom[i] = (random::u32() % 2) > 0;
 		}
+		updateKernels();
 	}
 
 	
@@ -193,6 +227,9 @@ struct Pulsars : Module {
 		// panelTheme
 		json_object_set_new(rootJ, "panelTheme", json_integer(panelTheme));
 
+		// randomSeed
+		json_object_set_new(rootJ, "randomSeed", rng.seedToJson());
+
 		// isVoid
 		json_object_set_new(rootJ, "isVoid0", json_real(isVoid[0]));
 		json_object_set_new(rootJ, "isVoid1", json_real(isVoid[1]));
@@ -220,6 +257,9 @@ struct Pulsars : Module {
 		if (panelThemeJ)
 			panelTheme = json_integer_value(panelThemeJ);
 
+		// randomSeed
+		rng.seedFromJson(json_object_get(rootJ, "randomSeed"));
+
 		// isVoid
 		json_t *isVoid0J = json_object_get(rootJ, "isVoid0");
 		if (isVoid0J)
@@ -266,17 +306,33 @@ struct Pulsars : Module {
 	}
 
 	
+#ifdef GEO_PROCESS_TIMING
+	ProcessTimeHistogram processTimes{this};
+#endif
+	
 	void process(const ProcessArgs &args) override {
+#ifdef GEO_PROCESS_TIMING
+		ProcessTimer processTimer(processTimes);
+#endif
+		DenormalGuard denormalGuard;
 		if (refresh.processInputs()) {
+			for (int i = 0; i < 2; i++) {
+				buttonTriggers.values[0 + i] = params[VOID_PARAMS + i].getValue() + inputs[VOID_INPUTS + i].getVoltage();
+				buttonTriggers.values[2 + i] = params[REV_PARAMS + i].getValue() + inputs[REV_INPUTS + i].getVoltage();
+				buttonTriggers.values[4 + i] = params[RND_PARAMS + i].getValue();
+				buttonTriggers.values[6 + i] = params[CVLEVEL_PARAMS + i].getValue();
+			}
+			uint32_t buttonTrigs = buttonTriggers.process();
+			
 			// Void, Reverse and Random buttons
 			for (int i = 0; i < 2; i++) {
-				if (voidTriggers[i].process(params[VOID_PARAMS + i].getValue() + inputs[VOID_INPUTS + i].getVoltage())) {
+				if ((buttonTrigs & (0x1 << (0 + i))) != 0) {
 					isVoid[i] = !isVoid[i];
 				}
-				if (revTriggers[i].process(params[REV_PARAMS + i].getValue() + inputs[REV_INPUTS + i].getVoltage())) {
+				if ((buttonTrigs & (0x1 << (2 + i))) != 0) {
 					isReverse[i] = !isReverse[i];
 				}
-				if (rndTriggers[i].process(params[RND_PARAMS + i].getValue())) {
+				if ((buttonTrigs & (0x1 << (4 + i))) != 0) {
 					isRandom[i] = !isRandom[i];
 					if (isRandom[i] && cvModes[i] == 2) {
 						updateConnectedRand(i);
@@ -286,7 +342,7 @@ struct Pulsars : Module {
 			
 			// CV Level buttons
 			for (int i = 0; i < 2; i++) {
-				if (cvLevelTriggers[i].process(params[CVLEVEL_PARAMS + i].getValue())) {
+				if ((buttonTrigs & (0x1 << (6 + i))) != 0) {
 					cvModes[i]++;
 					if (cvModes[i] > 2)
 						cvModes[i] = 0;
@@ -294,116 +350,19 @@ struct Pulsars : Module {
 				}
 			}
 			
-			updateConnected();
+			if ((buttonTrigs & 0xF) != 0)// void or reverse changed
+				updateConnected();
+			if ((buttonTrigs & 0xF0) != 0)// random or cv level changed
+				updateKernels();
 		}// userInputs refresh
+		connections.process(this, refresh.processInputs());// calls updateConnected() when cables change
 
 
-		// LFO values (normalized to 0.0f to 1.0f space, inputs clamped and offset adjusted depending cvMode)
-		float lfoVal[2];
-		lfoVal[0] = inputs[LFO_INPUTS + 0].getVoltage();
-		lfoVal[1] = inputs[LFO_INPUTS + 1].isConnected() ? inputs[LFO_INPUTS + 1].getVoltage() : lfoVal[0];
-		for (int i = 0; i < 2; i++)
-			lfoVal[i] = clamp( (lfoVal[i] + (cvModes[i] == 0 ? 5.0f : 0.0f)) / 10.0f , 0.0f , 1.0f);
-		
-		
-		// Pulsar A
-		if (connectedNum[0] > 0) {
-			float indexPercent;
-			float indexNextPercent;
-			int *srcConnected = connected[0];
-			if (cvModes[0] < 2) {
-				// regular modes
-				if (!isVoid[0]) {
-					if (index[0] >= connectedNum[0]) {// ensure start on valid input when no void
-						index[0] = 0;
-					}
-					if (indexNext[0] >= connectedNum[0]) {
-						updateIndexNext(0);
-					}
-				}			
-				indexPercent = topCross[0] ? (1.0f - lfoVal[0]) : lfoVal[0];
-				indexNextPercent = 1.0f - indexPercent;
-			}
-			else {
-				// new ALL mode
-				lfoVal[0] *= (float)connectedNum[0];
-				index[0] = (int)lfoVal[0];
-				indexNext[0] = (index[0] + 1);
-				indexNextPercent = lfoVal[0] - (float)index[0];
-				indexPercent = 1.0f - indexNextPercent;
-				if (index[0] >= connectedNum[0]) index[0] = 0;
-				if (indexNext[0] >= connectedNum[0]) indexNext[0] = 0;
-				if (isRandom[0])
-					srcConnected = connectedRand[0];
-			}
-			outputs[OUTA_OUTPUT].setVoltage(indexPercent * inputs[INA_INPUTS + srcConnected[index[0]]].getVoltage() + indexNextPercent * inputs[INA_INPUTS + srcConnected[indexNext[0]]].getVoltage());
-			for (int i = 0; i < 8; i++)
-				lights[MIXA_LIGHTS + i].setBrightness(0.0f + ((i == srcConnected[index[0]]) ? indexPercent : 0.0f) + ((i == srcConnected[indexNext[0]]) ? indexNextPercent : 0.0f));
-		}
-		else {
-			outputs[OUTA_OUTPUT].setVoltage(0.0f);
-			for (int i = 0; i < 8; i++)
-				lights[MIXA_LIGHTS + i].setBrightness(0.0f);
-		}
-
-
-		// Pulsar B
-		if (connectedNum[1] > 0) {
-			float indexPercent;
-			float indexNextPercent;
-			int *srcConnected = connected[1];
-			if (cvModes[1] < 2) {
-				// regular modes
-				if (!isVoid[1]) {
-					if (index[1] >= connectedNum[1]) {// ensure start on valid input when no void
-						index[1] = 0;
-					}
-					if (indexNext[1] >= connectedNum[1]) {
-						updateIndexNext(1);
-					}
-				}					
-				indexPercent = topCross[1] ? (1.0f - lfoVal[1]) : lfoVal[1];
-				indexNextPercent = 1.0f - indexPercent;
-			}
-			else {
-				// new ALL mode
-				lfoVal[1] *= (float)connectedNum[1];
-				index[1] = (int)lfoVal[1];
-				indexNext[1] = (index[1] + 1);
-				indexNextPercent = lfoVal[1] - (float)index[1];
-				indexPercent = 1.0f - indexNextPercent;
-				if (index[1] >= connectedNum[1]) index[1] = 0;
-				if (indexNext[1] >= connectedNum[1]) indexNext[1] = 0;
-				if (isRandom[1])
-					srcConnected = connectedRand[1];
-			}
-			for (int i = 0; i < 8; i++) {
-				if (inputs[INB_INPUT].isConnected())
-					outputs[OUTB_OUTPUTS + i].setVoltage(0.0f + ((i == srcConnected[index[1]]) ? (indexPercent * inputs[INB_INPUT].getVoltage()) : 0.0f) + ((i == srcConnected[indexNext[1]]) ? (indexNextPercent * inputs[INB_INPUT].getVoltage()) : 0.0f));
-				else// mutidimentional trick
-					outputs[OUTB_OUTPUTS + i].setVoltage(0.0f + ((i == srcConnected[index[1]]) ? (indexPercent * inputs[INA_INPUTS + i].getVoltage()) : 0.0f) + ((i == srcConnected[indexNext[1]]) ? (indexNextPercent * inputs[INA_INPUTS + i].getVoltage()) : 0.0f));
-				lights[MIXB_LIGHTS + i].setBrightness(0.0f + ((i == srcConnected[index[1]]) ? indexPercent : 0.0f) + ((i == srcConnected[indexNext[1]]) ? indexNextPercent : 0.0f));
-			}
-		}
-		else {
-			for (int i = 0; i < 8; i++) {
-				outputs[OUTB_OUTPUTS + i].setVoltage(0.0f);
-				lights[MIXB_LIGHTS + i].setBrightness(0.0f);
-			}
-		}
-
-		
-		// Pulsar crossovers (LFO detection)
-		for (int bnum = 0; bnum < 2; bnum++) {
-			if (cvModes[bnum] < 2) {
-				if ( (topCross[bnum] && lfoVal[bnum] > (1.0f - epsilon)) || (!topCross[bnum] && lfoVal[bnum] < epsilon) ) {
-					topCross[bnum] = !topCross[bnum];// switch to opposite detection
-					index[bnum] = indexNext[bnum];
-					updateIndexNext(bnum);
-					lfoLights[bnum] = 1.0f;
-				}
-			}
-		}
+		// LFO inputs, then the two pulsars with the kernels of their modes
+		float lfoIn0 = inputs[LFO_INPUTS + 0].getVoltage();
+		float lfoIn1 = connections.isInputConnected(LFO_INPUTS + 1) ? inputs[LFO_INPUTS + 1].getVoltage() : lfoIn0;
+		(this->*pulsarKernels[0])(lfoIn0);
+		(this->*pulsarKernels[1])(lfoIn1);
 
 		
 		// lights
@@ -427,13 +386,95 @@ struct Pulsars : Module {
 				lfoLights[i] = 0.0f;
 			}
 			
+			// Mix lights (MIXB_LIGHTS follow MIXA_LIGHTS), lights not held since the last refresh go dark
+			mixLights.takePeaks();
+			mixLights.write(&lights[MIXA_LIGHTS]);
+			
 		}// lightRefreshCounter
 		
 	}// step()
+	
+	
+	// One pulsar (bnum 0 is upper, 1 is lower) in the given cvMode and random mode, lfoIn is the LFO input in volts.
+	//   Instantiated for every mode combination and chosen by updateKernels(), so that the modes are not tested per sample
+	template<int BNUM, int CV_MODE, bool IS_RANDOM>
+	void processPulsar(float lfoIn) {
+		// LFO value (normalized to 0.0f to 1.0f space, input clamped and offset adjusted depending CV_MODE)
+		float lfoVal = clamp( (lfoIn + (CV_MODE == 0 ? 5.0f : 0.0f)) / 10.0f , 0.0f , 1.0f);
+		
+		if (connectedNum[BNUM] > 0) {
+			float indexPercent;
+			float indexNextPercent;
+			int *srcConnected = connected[BNUM];
+			if (CV_MODE < 2) {
+				// regular modes
+				if (!isVoid[BNUM]) {
+					if (index[BNUM] >= connectedNum[BNUM]) {// ensure start on valid input when no void
+						index[BNUM] = 0;
+					}
+					if (indexNext[BNUM] >= connectedNum[BNUM]) {
+						updateIndexNext(BNUM);
+					}
+				}			
+				indexPercent = topCross[BNUM] ? (1.0f - lfoVal) : lfoVal;
+				indexNextPercent = 1.0f - indexPercent;
+			}
+			else {
+				// new ALL mode
+				float lfoScaled = lfoVal * (float)connectedNum[BNUM];
+				index[BNUM] = (int)lfoScaled;
+				indexNext[BNUM] = (index[BNUM] + 1);
+				indexNextPercent = lfoScaled - (float)index[BNUM];
+				indexPercent = 1.0f - indexNextPercent;
+				if (index[BNUM] >= connectedNum[BNUM]) index[BNUM] = 0;
+				if (indexNext[BNUM] >= connectedNum[BNUM]) indexNext[BNUM] = 0;
+				if (IS_RANDOM)
+					srcConnected = connectedRand[BNUM];
+			}
+			if (BNUM == 0) {
+				outputs[OUTA_OUTPUT].setVoltage(indexPercent * inputs[INA_INPUTS + srcConnected[index[0]]].getVoltage() + indexNextPercent * inputs[INA_INPUTS + srcConnected[indexNext[0]]].getVoltage());
+			}
+			else {
+				for (int i = 0; i < 8; i++) {
+					if (connections.isInputConnected(INB_INPUT))
+						outputs[OUTB_OUTPUTS + i].setVoltage(0.0f + ((i == srcConnected[index[1]]) ? (indexPercent * inputs[INB_INPUT].getVoltage()) : 0.0f) + ((i == srcConnected[indexNext[1]]) ? (indexNextPercent * inputs[INB_INPUT].getVoltage()) : 0.0f));
+					else// mutidimentional trick
+						outputs[OUTB_OUTPUTS + i].setVoltage(0.0f + ((i == srcConnected[index[1]]) ? (indexPercent * inputs[INA_INPUTS + i].getVoltage()) : 0.0f) + ((i == srcConnected[indexNext[1]]) ? (indexNextPercent * inputs[INA_INPUTS + i].getVoltage()) : 0.0f));
+				}
+			}
+			holdMixLights(BNUM * 8, srcConnected[index[BNUM]], srcConnected[indexNext[BNUM]], indexPercent, indexNextPercent);
+		}
+		else {
+			if (BNUM == 0) {
+				outputs[OUTA_OUTPUT].setVoltage(0.0f);
+			}
+			else {
+				for (int i = 0; i < 8; i++) {
+					outputs[OUTB_OUTPUTS + i].setVoltage(0.0f);
+				}
+			}
+		}
+		
+		// Pulsar crossover (LFO detection)
+		if (CV_MODE < 2) {
+			if ( (topCross[BNUM] && lfoVal > (1.0f - epsilon)) || (!topCross[BNUM] && lfoVal < epsilon) ) {
+				topCross[BNUM] = !topCross[BNUM];// switch to opposite detection
+				index[BNUM] = indexNext[BNUM];
+				updateIndexNext(BNUM);
+				lfoLights[BNUM] = 1.0f;
+			}
+		}
+	}
 };
 
 
 struct PulsarsWidget : ModuleWidget {
+#ifdef GEO_PROCESS_TIMING
+	void appendContextMenu(Menu *menu) override {
+		appendProcessTimesMenu(menu, module);
+	}
+	
+#endif
 	PulsarsWidget(Pulsars *module) {
 		setModule(module);
 
@@ -16,44 +16,43 @@ struct chanVol {// a mixMap for an output has four of these, for each quadrant t
 	float vol;// 0.0 to 1.0
 	float chan;// channel input number (0 to 15)
 	bool inputIsAboveOutput;// true when an input is located above the output, false otherwise
-	OnePoleFilter filt;// a lowpass filter (highpass is done using "inval - outval" trick
 	
-	void writeChan(float _vol, int _chan, bool _inAboveOut, float norm_f_c) {
+	void writeChan(float _vol, int _chan, bool _inAboveOut) {
 		vol = _vol;
 		chan = _chan;
 		inputIsAboveOutput = _inAboveOut;
-		filt.setCutoff(norm_f_c);		
-	}
-	
-	float processFilter(float inval) {
-		float outval = filt.process(inval);
-		return (inputIsAboveOutput ? outval : (inval - outval));// inputIsAboveOutput ? lowpass : highpass		
 	}
 };
 
 
 struct mixMapOutput {
 	chanVol cvs[4];// an output can have a mix of at most 4 inputs
+	OnePoleFilterBank<4> filters;// lane i is the filter of cvs[i], a lowpass when its input is above the output, else a highpass
+	simd::float_4 isLowpass;// 1.0f in the lanes of filters that are lowpass, else 0.0f
 	int numInputs;// number of inputs that need to be read for this given output
 	float sampleRate;
 
 	void init(float _sampleRate) {
 		sampleRate = _sampleRate;
 		numInputs = 0;
+		isLowpass = simd::float_4::zero();
 	}
 	
 	float getScaledInput(int index, float inval) {
 		return inval * cvs[index].vol;
 	}		
 
-	float getFilteredInput(int index, float inval) {
-		return cvs[index].processFilter(inval);
+	simd::float_4 getFilteredInputs(simd::float_4 invals) {// unused lanes are also filtered (in is 0V), ignore them
+		filters.process(0, invals);
+		return simd::ifelse(isLowpass > 0.0f, filters.lowpass(0), filters.highpass(0));
 	}
 
 	void insert(int numerator, int denominator, int mixmode, float _chan, bool _inAboveOut) {
 		float _vol = (mixmode == 1 ? 1.0f : ((float)numerator / (float)denominator));
 		float f_c = (float)calcCutoffFreq(numerator, denominator, _inAboveOut);
-		cvs[numInputs].writeChan(_vol, _chan, _inAboveOut, f_c / sampleRate);
+		cvs[numInputs].writeChan(_vol, _chan, _inAboveOut);
+		filters.setCutoff(numInputs, f_c / sampleRate);
+		isLowpass[numInputs] = _inAboveOut ? 1.0f : 0.0f;
 		numInputs++;
 	}
 		
@@ -137,15 +136,22 @@ struct Torus : Module {
 	
 	// Need to save, no reset
 	int panelTheme;
+	ParamRamps<1> gain;// blockSize is saved
+	ThroughputBlock<16, 7> throughput;// inputs MIX, outputs MIX; blockSize is saved
 	
 	// Need to save, with reset
 	int mixmode;// 0 is decay, 1 is constant, 2 is filter
 	
 	// No need to save, with reset
-	mixMapOutput mixMap[7];// 7 outputs
+	mixMapOutput mixMap[7];// 7 outputs, rebuilt when cables, mixmode or sample rate change
+	ConnectionMasks connections;
+	typedef void (Torus::*MixKernel)(float gainValue);
+	MixKernel mixKernel;// mixOutputs() of the mixmode, set with the mixMap
+	typedef void (Torus::*MixBlockKernel)();
+	MixBlockKernel mixBlockKernel;// mixOutputsBlock() of the mixmode, idem
 	
 	// No need to save, no reset
-	RefreshCounter refresh;
+	RefreshCounter refresh{38.0f, 76.0f};
 	Trigger modeTrigger;
 	
 	
@@ -167,11 +173,15 @@ struct Torus : Module {
 	}
 	void resetNonJson() {
 		updateMixMap(APP->engine->getSampleRate());
+		connections.reset();// rescan on next process()
+		gain.reset();
+		throughput.reset();
 	}
 
 
 	void onRandomize() override {
 		mixmode = random::u32() % 3;
+		updateMixMap(APP->engine->getSampleRate());
 	}
 	
 
@@ -181,6 +191,12 @@ struct Torus : Module {
 		// panelTheme
 		json_object_set_new(rootJ, "panelTheme", json_integer(panelTheme));
 
+		// paramBlockSize
+		json_object_set_new(rootJ, "paramBlockSize", json_integer(gain.blockSize));
+
+		// throughputBlockSize
+		json_object_set_new(rootJ, "throughputBlockSize", json_integer(throughput.blockSize));
+
 		// mixmode
 		json_object_set_new(rootJ, "mixmode", json_integer(mixmode));
 
@@ -194,6 +210,16 @@ struct Torus : Module {
 		if (panelThemeJ)
 			panelTheme = json_integer_value(panelThemeJ);
 
+		// paramBlockSize
+		json_t *paramBlockSizeJ = json_object_get(rootJ, "paramBlockSize");
+		if (paramBlockSizeJ)
+			gain.blockSize = ParamRamps<1>::normalizeBlockSize(json_integer_value(paramBlockSizeJ));
+
+		// throughputBlockSize
+		json_t *throughputBlockSizeJ = json_object_get(rootJ, "throughputBlockSize");
+		if (throughputBlockSizeJ)
+			throughput.blockSize = ThroughputBlock<16, 7>::normalizeBlockSize(json_integer_value(throughputBlockSizeJ));
+
 		// mixmode
 		json_t *mixmodeJ = json_object_get(rootJ, "mixmode");
 		if (mixmodeJ)
@@ -203,26 +229,58 @@ struct Torus : Module {
 	}
 	
 
+	void onSampleRateChange() override {
+		updateMixMap(APP->engine->getSampleRate());
+	}
+	
+	
+	void onConnectionsChanged(const ConnectionMasks &oldMasks, const ConnectionMasks &newMasks) {
+		updateMixMap(APP->engine->getSampleRate());
+	}
+	
+
+#ifdef GEO_PROCESS_TIMING
+	ProcessTimeHistogram processTimes{this};
+#endif
+#ifdef GEO_DENORMAL_COUNT
+	DenormalCounters denormalCounts{this, {"filter lowout"}};
+#endif
+	
 	void process(const ProcessArgs &args) override {		
+#ifdef GEO_PROCESS_TIMING
+		ProcessTimer processTimer(processTimes);
+#endif
+		DenormalGuard denormalGuard;
 		// user inputs
 		if (refresh.processInputs()) {
 			// mixmode
 			if (modeTrigger.process(params[MODE_PARAM].getValue())) {
 				if (++mixmode > 2)
 					mixmode = 0;
+				updateMixMap(args.sampleRate);
 			}
-			
-			updateMixMap(args.sampleRate);
 		}// userInputs refresh
+		connections.process(this, refresh.processInputs());// calls updateMixMap() when cables change
 		
 		
-		// mixer code
-		for (int outi = 0; outi < 7; outi++) {
-			float outValue = 0.0f;
-			if (outputs[MIX_OUTPUTS + outi].isConnected()) {
-				outValue = clamp(calcOutput(outi) * params[GAIN_PARAM].getValue(), -10.0f, 10.0f);
+		if (throughput.sync(&outputs[MIX_OUTPUTS])) {
+			// Throughput mode, the outputs are one block late
+			for (int i = 0; i < 16; i++)
+				throughput.ins[i][throughput.pos] = inputs[MIX_INPUTS + i].getVoltage();
+			if (throughput.next(&outputs[MIX_OUTPUTS]))
+				(this->*mixBlockKernel)();
+		}
+		else {
+			// gain, at control rate
+			if (gain.isBlockStart()) {
+				gain.targets[0] = params[GAIN_PARAM].getValue();
+				gain.start();
 			}
-			outputs[MIX_OUTPUTS + outi].setVoltage(outValue);
+			gain.next();
+			float gainValue = gain.get(0);
+			
+			// mixer code
+			(this->*mixKernel)(gainValue);
 		}
 		
 
@@ -236,6 +294,8 @@ struct Torus : Module {
 	
 	
 	void updateMixMap(float sampleRate) {
+		mixKernel = (mixmode == 2 ? &Torus::mixOutputs<true> : &Torus::mixOutputs<false>);
+		mixBlockKernel = (mixmode == 2 ? &Torus::mixOutputsBlock<true> : &Torus::mixOutputsBlock<false>);
 		for (int outi = 0; outi < 7; outi++) {
 			mixMap[outi].init(sampleRate);
 		}
@@ -248,7 +308,7 @@ struct Torus : Module {
 			distanceUR++;
 			
 			// left side
-			if (inputs[MIX_INPUTS + ini].isConnected()) {
+			if (connections.isInputConnected(MIX_INPUTS + ini)) {
 				for (int outi = ini - 1 ; outi >= 0; outi--) {
 					int numerator = (distanceUL - ini + outi);
 					if (numerator == 0) 
@@ -259,7 +319,7 @@ struct Torus : Module {
 			}
 			
 			// right side
-			if (inputs[MIX_INPUTS + 8 + ini].isConnected()) {
+			if (connections.isInputConnected(MIX_INPUTS + 8 + ini)) {
 				for (int outi = ini - 1 ; outi >= 0; outi--) {
 					int numerator = (distanceUR - ini + outi);
 					if (numerator == 0) 
@@ -278,7 +338,7 @@ struct Torus : Module {
 			distanceDR++;
 			
 			// left side
-			if (inputs[MIX_INPUTS + ini].isConnected()) {
+			if (connections.isInputConnected(MIX_INPUTS + ini)) {
 				for (int outi = ini ; outi < 7; outi++) {
 					int numerator = (distanceDL - 1 + ini - outi);
 					if (numerator == 0) 
@@ -289,7 +349,7 @@ struct Torus : Module {
 			}
 			
 			// right side
-			if (inputs[MIX_INPUTS + 8 + ini].isConnected()) {
+			if (connections.isInputConnected(MIX_INPUTS + 8 + ini)) {
 				for (int outi = ini ; outi < 7; outi++) {
 					int numerator = (distanceDR - 1 + ini - outi);
 					if (numerator == 0) 
@@ -302,19 +362,89 @@ struct Torus : Module {
 	}
 	
 	
+	// All outputs in the decay and constant modes (their volumes are in the mixMap) or in the filter mode,
+	//   chosen with the mixMap by updateMixMap()
+	template<bool IS_FILTER>
+	void mixOutputs(float gainValue) {
+		for (int outi = 0; outi < 7; outi++) {
+			float outValue = 0.0f;
+			if (connections.isOutputConnected(MIX_OUTPUTS + outi)) {
+				outValue = clamp(calcOutput<IS_FILTER>(outi) * gainValue, -10.0f, 10.0f);
+#ifdef GEO_DENORMAL_COUNT
+				if (IS_FILTER)
+					denormalCounts.check(0, mixMap[outi].filters.lowout[0]);
+#endif
+			}
+			outputs[MIX_OUTPUTS + outi].setVoltage(outValue);
+		}
+	}
+	
+	// Block kernel of mixOutputs() for the throughput mode, on the inputs collected in throughput.ins[]; the gain is
+	//   evaluated once per block and ramped over it. The volumes are applied 4 samples per vector, the filters (whose
+	//   lanes are the inputs of an output) sample by sample
+	template<bool IS_FILTER>
+	void mixOutputsBlock() {
+		int size = throughput.size;
+		gain.targets[0] = params[GAIN_PARAM].getValue();
+		gain.start(size);
+		for (int outi = 0; outi < 7; outi++) {
+			float *out = throughput.outs[outi];
+			mixMapOutput &map = mixMap[outi];
+			if (!connections.isOutputConnected(MIX_OUTPUTS + outi)) {
+				for (int s = 0; s < size; s += 4)
+					simd::float_4::zero().store(&out[s]);
+				continue;
+			}
+			if (!IS_FILTER) {// constant or decay modes
+				for (int s = 0; s < size; s += 4) {
+					simd::float_4 outputValue = simd::float_4::zero();
+					for (int i = 0; i < map.numInputs; i++)
+						outputValue += simd::float_4::load(&throughput.ins[(int)map.cvs[i].chan][s]) * map.cvs[i].vol;
+					outputValue.store(&out[s]);
+				}
+			}
+			else {// filter mode
+				const float *ins[4];
+				for (int i = 0; i < 4; i++)
+					ins[i] = i < map.numInputs ? throughput.ins[(int)map.cvs[i].chan] : NULL;
+				for (int s = 0; s < size; s++) {
+					float invals[4];
+					for (int i = 0; i < 4; i++)
+						invals[i] = ins[i] ? ins[i][s] : 0.0f;
+					simd::float_4 filtered = map.getFilteredInputs(simd::float_4(invals[0], invals[1], invals[2], invals[3]));
+					float outputValue = 0.0f;
+					for (int i = 0; i < map.numInputs; i++)
+						outputValue += filtered[i];
+					out[s] = outputValue;
+				}
+#ifdef GEO_DENORMAL_COUNT
+				denormalCounts.check(0, map.filters.lowout[0]);
+#endif
+			}
+			for (int s = 0; s < size; s += 4) {
+				simd::float_4 gainValue = gain.get(0) + gain.getStep(0) * (simd::float_4(1.0f, 2.0f, 3.0f, 4.0f) + (float)s);
+				simd::clamp(simd::float_4::load(&out[s]) * gainValue, -10.0f, 10.0f).store(&out[s]);
+			}
+		}
+		gain.skip(size);
+	}
+	
+	template<bool IS_FILTER>
 	float calcOutput(int outi) {
 		float outputValue = 0.0f;
-		if (mixmode < 2) {// constant or decay modes	
+		if (!IS_FILTER) {// constant or decay modes	
 			for (int i = 0; i < mixMap[outi].numInputs; i++) {
 				int chan = mixMap[outi].cvs[i].chan;
 				outputValue += mixMap[outi].getScaledInput(i, inputs[MIX_INPUTS + chan].getVoltage());
 			}
 		}
 		else {// filter mode
-			for (int i = 0; i < mixMap[outi].numInputs; i++) {
-				int chan = mixMap[outi].cvs[i].chan;
-				outputValue += mixMap[outi].getFilteredInput(i, inputs[MIX_INPUTS + chan].getVoltage());
-			}
+			float invals[4];
+			for (int i = 0; i < 4; i++)
+				invals[i] = i < mixMap[outi].numInputs ? inputs[MIX_INPUTS + (int)mixMap[outi].cvs[i].chan].getVoltage() : 0.0f;
+			simd::float_4 filtered = mixMap[outi].getFilteredInputs(simd::float_4(invals[0], invals[1], invals[2], invals[3]));
+			for (int i = 0; i < mixMap[outi].numInputs; i++)
+				outputValue += filtered[i];
 		}
 		return outputValue;
 	}
@@ -322,6 +452,18 @@ struct Torus : Module {
 
 
 struct TorusWidget : ModuleWidget {
+	void appendContextMenu(Menu *menu) override {
+		Torus *module = dynamic_cast<Torus*>(this->module);
+		assert(module);
+		
+		appendParamBlockSizeMenu(menu, &module->gain.blockSize);
+		appendThroughputMenu(menu, &module->throughput.blockSize, module->throughput.getLatency());
+		
+#ifdef GEO_PROCESS_TIMING
+		appendProcessTimesMenu(menu, module);
+#endif
+	}
+	
 	TorusWidget(Torus *module) {
 		setModule(module);
 